@@ -0,0 +1,696 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include "skiplist.h"
+#include "baselines.h"
+
+//Keys per leaf and per inner node of the B+-tree
+#define B_PLUS_TREE_ORDER 32
+#define HASH_TABLE_INITIAL_CAPACITY 16
+
+/*****************************************************************/
+/*************************** Skip List ***************************/
+/*****************************************************************/
+
+//context of skiplist_scan()
+typedef struct{
+	unsigned int remaining;
+	uintptr_t* checksum;
+}skiplist_scan_context;
+
+void* skiplist_create(unsigned int layers, unsigned int flags){
+	return sl_create_custom_skip_list(layers, flags, NULL);
+}
+
+void skiplist_destroy(void* container){
+	sl_remove_skip_list(container);
+}
+
+bool skiplist_insert(void* container, unsigned int key, uintptr_t value){
+	return sl_upsert(container, key, (void*)value) != NULL;
+}
+
+bool skiplist_get(void* container, unsigned int key, uintptr_t* value){
+	sl_node* node = sl_get_node(container, key);
+	if(node == NULL)
+		return false;
+	*value = (uintptr_t)node->data;
+	return true;
+}
+
+bool visit_skiplist_node(sl_node* node, void* context){
+	skiplist_scan_context* scan = context;
+	*scan->checksum += (uintptr_t)node->data;
+	return --scan->remaining > 0;
+}
+
+unsigned int skiplist_scan(void* container, unsigned int key, unsigned int count, uintptr_t* checksum){
+	if(count == 0)
+		return 0;
+	skiplist_scan_context scan = { .remaining = count, .checksum = checksum };
+	return sl_scan_range(container, key, UINT_MAX, visit_skiplist_node, &scan);
+}
+
+size_t skiplist_get_memory_usage(void* container){
+	return sl_get_memory_usage(container);
+}
+
+const container_operations skiplist_container = {
+	"skiplist", skiplist_create, skiplist_destroy, skiplist_insert, skiplist_get, skiplist_scan, skiplist_get_memory_usage, NULL
+};
+
+/*****************************************************************/
+/************************* Sorted Array **************************/
+/*****************************************************************/
+
+typedef struct{
+	unsigned int* keys;
+	uintptr_t* values;
+	unsigned int count;
+	unsigned int capacity;
+}sorted_array;
+
+//pair that's sorted by sorted_array_load()
+typedef struct{
+	unsigned int key;
+	uintptr_t value;
+}key_value_pair;
+
+//Returns the index of the first key >= key
+unsigned int sorted_array_lower_bound(sorted_array* array, unsigned int key){
+	unsigned int low = 0;
+	unsigned int high = array->count;
+	while(low < high){
+		unsigned int middle = low + (high - low) / 2;
+		if(array->keys[middle] < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+bool sorted_array_reserve(sorted_array* array, unsigned int capacity){
+	if(capacity <= array->capacity)
+		return true;
+	unsigned int* keys = realloc(array->keys, sizeof(unsigned int) * capacity);
+	if(keys == NULL)
+		return false;
+	array->keys = keys;
+	uintptr_t* values = realloc(array->values, sizeof(uintptr_t) * capacity);
+	if(values == NULL)
+		return false;
+	array->values = values;
+	array->capacity = capacity;
+	return true;
+}
+
+void* sorted_array_create(unsigned int layers, unsigned int flags){
+	return calloc(1, sizeof(sorted_array));
+}
+
+void sorted_array_destroy(void* container){
+	sorted_array* array = container;
+	free(array->keys);
+	free(array->values);
+	free(array);
+}
+
+bool sorted_array_insert(void* container, unsigned int key, uintptr_t value){
+	sorted_array* array = container;
+	unsigned int index = sorted_array_lower_bound(array, key);
+	if(index < array->count  &&  array->keys[index] == key){
+		array->values[index] = value;
+		return true;
+	}
+	if(array->count == array->capacity  &&  !sorted_array_reserve(array, array->capacity == 0 ? 16 : array->capacity * 2))
+		return false;
+
+	//Move the tail one entry back:
+	memmove(array->keys + index + 1, array->keys + index, sizeof(unsigned int) * (array->count - index));
+	memmove(array->values + index + 1, array->values + index, sizeof(uintptr_t) * (array->count - index));
+	array->keys[index] = key;
+	array->values[index] = value;
+	array->count++;
+	return true;
+}
+
+bool sorted_array_get(void* container, unsigned int key, uintptr_t* value){
+	sorted_array* array = container;
+	unsigned int index = sorted_array_lower_bound(array, key);
+	if(index == array->count  ||  array->keys[index] != key)
+		return false;
+	*value = array->values[index];
+	return true;
+}
+
+unsigned int sorted_array_scan(void* container, unsigned int key, unsigned int count, uintptr_t* checksum){
+	sorted_array* array = container;
+	unsigned int index = sorted_array_lower_bound(array, key);
+	unsigned int visited_count = 0;
+	for(; index < array->count  &&  visited_count < count; index++, visited_count++)
+		*checksum += array->values[index];
+	return visited_count;
+}
+
+size_t sorted_array_get_memory_usage(void* container){
+	sorted_array* array = container;
+	return sizeof(sorted_array) + (size_t)array->capacity * (sizeof(unsigned int) + sizeof(uintptr_t));
+}
+
+int compare_key_value_pairs(const void* a, const void* b){
+	unsigned int first = ((const key_value_pair*)a)->key;
+	unsigned int second = ((const key_value_pair*)b)->key;
+	return (first > second) - (first < second);
+}
+
+bool sorted_array_load(void* container, const unsigned int* keys, const uintptr_t* values, unsigned int count){
+	sorted_array* array = container;
+	key_value_pair* pairs = malloc(sizeof(key_value_pair) * count);
+	if(pairs == NULL  ||  array->count != 0  ||  !sorted_array_reserve(array, count)){
+		free(pairs);
+		return false;
+	}
+
+	//Sort once instead of moving the tail for every key, the last value of a key wins like with insert():
+	for(unsigned int i = 0; i < count; i++){
+		pairs[i].key = keys[i];
+		pairs[i].value = values[i];
+	}
+	qsort(pairs, count, sizeof(key_value_pair), compare_key_value_pairs);
+	for(unsigned int i = 0; i < count; i++){
+		if(array->count > 0  &&  array->keys[array->count - 1] == pairs[i].key){
+			array->values[array->count - 1] = pairs[i].value;
+			continue;
+		}
+		array->keys[array->count] = pairs[i].key;
+		array->values[array->count] = pairs[i].value;
+		array->count++;
+	}
+	free(pairs);
+	return true;
+}
+
+const container_operations sorted_array_container = {
+	"array", sorted_array_create, sorted_array_destroy, sorted_array_insert, sorted_array_get, sorted_array_scan,
+	sorted_array_get_memory_usage, sorted_array_load
+};
+
+/*****************************************************************/
+/************************ Red-Black Tree *************************/
+/*****************************************************************/
+
+typedef struct _rb_node{
+	unsigned int key;
+	bool is_red;
+	uintptr_t value;
+	struct _rb_node* left;
+	struct _rb_node* right;
+	struct _rb_node* parent;
+}rb_node;
+
+typedef struct{
+	rb_node* root;
+	unsigned int count;
+}rb_tree;
+
+void* rb_create(unsigned int layers, unsigned int flags){
+	return calloc(1, sizeof(rb_tree));
+}
+
+void rb_destroy(void* container){
+	rb_tree* tree = container;
+
+	//Free the nodes without recursion, every node is freed after its subtrees:
+	rb_node* node = tree->root;
+	while(node != NULL){
+		if(node->left != NULL){
+			node = node->left;
+		}
+		else if(node->right != NULL){
+			node = node->right;
+		}
+		else{
+			rb_node* parent = node->parent;
+			if(parent != NULL){
+				if(parent->left == node)
+					parent->left = NULL;
+				else
+					parent->right = NULL;
+			}
+			free(node);
+			node = parent;
+		}
+	}
+	free(tree);
+}
+
+void rb_rotate_left(rb_tree* tree, rb_node* node){
+	rb_node* child = node->right;
+	node->right = child->left;
+	if(child->left != NULL)
+		child->left->parent = node;
+	child->parent = node->parent;
+	if(node->parent == NULL)
+		tree->root = child;
+	else if(node == node->parent->left)
+		node->parent->left = child;
+	else
+		node->parent->right = child;
+	child->left = node;
+	node->parent = child;
+}
+
+void rb_rotate_right(rb_tree* tree, rb_node* node){
+	rb_node* child = node->left;
+	node->left = child->right;
+	if(child->right != NULL)
+		child->right->parent = node;
+	child->parent = node->parent;
+	if(node->parent == NULL)
+		tree->root = child;
+	else if(node == node->parent->right)
+		node->parent->right = child;
+	else
+		node->parent->left = child;
+	child->right = node;
+	node->parent = child;
+}
+
+bool rb_insert(void* container, unsigned int key, uintptr_t value){
+	rb_tree* tree = container;
+	rb_node* parent = NULL;
+	rb_node** link = &tree->root;
+	while(*link != NULL){
+		parent = *link;
+		if(key == parent->key){
+			parent->value = value;
+			return true;
+		}
+		link = key < parent->key ? &parent->left : &parent->right;
+	}
+
+	rb_node* node = malloc(sizeof(rb_node));
+	if(node == NULL)
+		return false;
+	node->key = key;
+	node->value = value;
+	node->is_red = true;
+	node->left = NULL;
+	node->right = NULL;
+	node->parent = parent;
+	*link = node;
+	tree->count++;
+
+	//Repair red nodes with red parents (Cormen et al.):
+	while(node->parent != NULL  &&  node->parent->is_red){
+		rb_node* grandparent = node->parent->parent;
+		if(node->parent == grandparent->left){
+			rb_node* uncle = grandparent->right;
+			if(uncle != NULL  &&  uncle->is_red){
+				node->parent->is_red = false;
+				uncle->is_red = false;
+				grandparent->is_red = true;
+				node = grandparent;
+				continue;
+			}
+			if(node == node->parent->right){
+				node = node->parent;
+				rb_rotate_left(tree, node);
+			}
+			node->parent->is_red = false;
+			grandparent->is_red = true;
+			rb_rotate_right(tree, grandparent);
+		}
+		else{
+			rb_node* uncle = grandparent->left;
+			if(uncle != NULL  &&  uncle->is_red){
+				node->parent->is_red = false;
+				uncle->is_red = false;
+				grandparent->is_red = true;
+				node = grandparent;
+				continue;
+			}
+			if(node == node->parent->left){
+				node = node->parent;
+				rb_rotate_right(tree, node);
+			}
+			node->parent->is_red = false;
+			grandparent->is_red = true;
+			rb_rotate_left(tree, grandparent);
+		}
+	}
+	tree->root->is_red = false;
+	return true;
+}
+
+bool rb_get(void* container, unsigned int key, uintptr_t* value){
+	rb_node* node = ((rb_tree*)container)->root;
+	while(node != NULL){
+		if(key == node->key){
+			*value = node->value;
+			return true;
+		}
+		node = key < node->key ? node->left : node->right;
+	}
+	return false;
+}
+
+unsigned int rb_scan(void* container, unsigned int key, unsigned int count, uintptr_t* checksum){
+	//Find the first node >= key:
+	rb_node* node = ((rb_tree*)container)->root;
+	rb_node* first_node = NULL;
+	while(node != NULL){
+		if(node->key >= key){
+			first_node = node;
+			node = node->left;
+		}
+		else{
+			node = node->right;
+		}
+	}
+
+	//Walk in order with the parent pointers:
+	unsigned int visited_count = 0;
+	for(node = first_node; node != NULL  &&  visited_count < count; visited_count++){
+		*checksum += node->value;
+		if(node->right != NULL){
+			node = node->right;
+			while(node->left != NULL)
+				node = node->left;
+		}
+		else{
+			while(node->parent != NULL  &&  node == node->parent->right)
+				node = node->parent;
+			node = node->parent;
+		}
+	}
+	return visited_count;
+}
+
+size_t rb_get_memory_usage(void* container){
+	return sizeof(rb_tree) + (size_t)((rb_tree*)container)->count * sizeof(rb_node);
+}
+
+const container_operations red_black_tree_container = {
+	"rbtree", rb_create, rb_destroy, rb_insert, rb_get, rb_scan, rb_get_memory_usage, NULL
+};
+
+/*****************************************************************/
+/*************************** B+-Tree *****************************/
+/*****************************************************************/
+
+//node of the B+-tree, leaves hold values and are linked, inner nodes hold count + 1 children
+typedef struct _bp_node{
+	bool is_leaf;
+	unsigned int count;
+	unsigned int keys[B_PLUS_TREE_ORDER];
+	union{
+		uintptr_t values[B_PLUS_TREE_ORDER];
+		struct _bp_node* children[B_PLUS_TREE_ORDER + 1];
+	};
+	//next leaf in key order
+	struct _bp_node* next_leaf;
+}bp_node;
+
+typedef struct{
+	bp_node* root;
+	size_t node_count;
+}bp_tree;
+
+bp_node* bp_create_node(bp_tree* tree, bool is_leaf){
+	bp_node* node = malloc(sizeof(bp_node));
+	if(node == NULL)
+		return NULL;
+	node->is_leaf = is_leaf;
+	node->count = 0;
+	node->next_leaf = NULL;
+	tree->node_count++;
+	return node;
+}
+
+void* bp_create(unsigned int layers, unsigned int flags){
+	bp_tree* tree = malloc(sizeof(bp_tree));
+	if(tree == NULL)
+		return NULL;
+	tree->node_count = 0;
+	tree->root = bp_create_node(tree, true);
+	if(tree->root == NULL){
+		free(tree);
+		return NULL;
+	}
+	return tree;
+}
+
+void bp_destroy_node(bp_node* node){
+	if(!node->is_leaf){
+		for(unsigned int i = 0; i <= node->count; i++)
+			bp_destroy_node(node->children[i]);
+	}
+	free(node);
+}
+
+void bp_destroy(void* container){
+	bp_tree* tree = container;
+	bp_destroy_node(tree->root);
+	free(tree);
+}
+
+//Returns the index of the first key >= key in a node
+unsigned int bp_lower_bound(const bp_node* node, unsigned int key){
+	unsigned int low = 0;
+	unsigned int high = node->count;
+	while(low < high){
+		unsigned int middle = (low + high) / 2;
+		if(node->keys[middle] < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+//Child of an inner node that holds key, keys[i] is the lowest key of children[i + 1]
+unsigned int bp_child_index(const bp_node* node, unsigned int key){
+	unsigned int index = bp_lower_bound(node, key);
+	return index < node->count  &&  node->keys[index] == key ? index + 1 : index;
+}
+
+//Inserts into the subtree of node. If node was split, *split_node is the new right sibling and *split_key its lowest key
+bool bp_insert_into(bp_tree* tree, bp_node* node, unsigned int key, uintptr_t value, bp_node** split_node, unsigned int* split_key){
+	*split_node = NULL;
+
+	if(node->is_leaf){
+		unsigned int index = bp_lower_bound(node, key);
+		if(index < node->count  &&  node->keys[index] == key){
+			node->values[index] = value;
+			return true;
+		}
+		memmove(node->keys + index + 1, node->keys + index, sizeof(unsigned int) * (node->count - index));
+		memmove(node->values + index + 1, node->values + index, sizeof(uintptr_t) * (node->count - index));
+		node->keys[index] = key;
+		node->values[index] = value;
+		node->count++;
+	}
+	else{
+		unsigned int index = bp_child_index(node, key);
+		bp_node* child_split;
+		unsigned int child_split_key;
+		if(!bp_insert_into(tree, node->children[index], key, value, &child_split, &child_split_key))
+			return false;
+		if(child_split == NULL)
+			return true;
+		//The new child lies behind children[index]:
+		memmove(node->keys + index + 1, node->keys + index, sizeof(unsigned int) * (node->count - index));
+		memmove(node->children + index + 2, node->children + index + 1, sizeof(bp_node*) * (node->count - index));
+		node->keys[index] = child_split_key;
+		node->children[index + 1] = child_split;
+		node->count++;
+	}
+
+	//A full node is split in half before the next insertion needs the space:
+	if(node->count < B_PLUS_TREE_ORDER)
+		return true;
+	bp_node* sibling = bp_create_node(tree, node->is_leaf);
+	if(sibling == NULL)
+		return false;
+	unsigned int half = node->count / 2;
+	if(node->is_leaf){
+		sibling->count = node->count - half;
+		memcpy(sibling->keys, node->keys + half, sizeof(unsigned int) * sibling->count);
+		memcpy(sibling->values, node->values + half, sizeof(uintptr_t) * sibling->count);
+		node->count = half;
+		sibling->next_leaf = node->next_leaf;
+		node->next_leaf = sibling;
+		*split_key = sibling->keys[0];
+	}
+	else{
+		//keys[half] moves up, the sibling gets the keys and children behind it:
+		sibling->count = node->count - half - 1;
+		memcpy(sibling->keys, node->keys + half + 1, sizeof(unsigned int) * sibling->count);
+		memcpy(sibling->children, node->children + half + 1, sizeof(bp_node*) * (sibling->count + 1));
+		*split_key = node->keys[half];
+		node->count = half;
+	}
+	*split_node = sibling;
+	return true;
+}
+
+bool bp_insert(void* container, unsigned int key, uintptr_t value){
+	bp_tree* tree = container;
+	bp_node* split_node;
+	unsigned int split_key;
+	if(!bp_insert_into(tree, tree->root, key, value, &split_node, &split_key))
+		return false;
+	if(split_node == NULL)
+		return true;
+
+	//The root was split, the tree grows by one level:
+	bp_node* root = bp_create_node(tree, false);
+	if(root == NULL)
+		return false;
+	root->count = 1;
+	root->keys[0] = split_key;
+	root->children[0] = tree->root;
+	root->children[1] = split_node;
+	tree->root = root;
+	return true;
+}
+
+bp_node* bp_find_leaf(bp_tree* tree, unsigned int key){
+	bp_node* node = tree->root;
+	while(!node->is_leaf)
+		node = node->children[bp_child_index(node, key)];
+	return node;
+}
+
+bool bp_get(void* container, unsigned int key, uintptr_t* value){
+	bp_node* leaf = bp_find_leaf(container, key);
+	unsigned int index = bp_lower_bound(leaf, key);
+	if(index == leaf->count  ||  leaf->keys[index] != key)
+		return false;
+	*value = leaf->values[index];
+	return true;
+}
+
+unsigned int bp_scan(void* container, unsigned int key, unsigned int count, uintptr_t* checksum){
+	bp_node* leaf = bp_find_leaf(container, key);
+	unsigned int index = bp_lower_bound(leaf, key);
+	unsigned int visited_count = 0;
+
+	//Follow the linked leaves:
+	for(; leaf != NULL  &&  visited_count < count; leaf = leaf->next_leaf, index = 0){
+		for(; index < leaf->count  &&  visited_count < count; index++, visited_count++)
+			*checksum += leaf->values[index];
+	}
+	return visited_count;
+}
+
+size_t bp_get_memory_usage(void* container){
+	return sizeof(bp_tree) + ((bp_tree*)container)->node_count * sizeof(bp_node);
+}
+
+const container_operations b_plus_tree_container = {
+	"bptree", bp_create, bp_destroy, bp_insert, bp_get, bp_scan, bp_get_memory_usage, NULL
+};
+
+/*****************************************************************/
+/************************** Hash Table ***************************/
+/*****************************************************************/
+
+typedef struct{
+	unsigned int key;
+	bool is_used;
+	uintptr_t value;
+}hash_slot;
+
+typedef struct{
+	hash_slot* slots;
+	//power of 2
+	size_t capacity;
+	size_t count;
+}hash_table;
+
+size_t hash_key(unsigned int key, size_t capacity){
+	//Fibonacci hashing, the high bits are the best mixed ones:
+	return (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+void* hash_create(unsigned int layers, unsigned int flags){
+	hash_table* table = malloc(sizeof(hash_table));
+	if(table == NULL)
+		return NULL;
+	table->capacity = HASH_TABLE_INITIAL_CAPACITY;
+	table->count = 0;
+	table->slots = calloc(table->capacity, sizeof(hash_slot));
+	if(table->slots == NULL){
+		free(table);
+		return NULL;
+	}
+	return table;
+}
+
+void hash_destroy(void* container){
+	hash_table* table = container;
+	free(table->slots);
+	free(table);
+}
+
+//Returns the slot of key or the empty slot where it belongs
+hash_slot* hash_find_slot(hash_slot* slots, size_t capacity, unsigned int key){
+	size_t index = hash_key(key, capacity);
+	while(slots[index].is_used  &&  slots[index].key != key)
+		index = (index + 1) & (capacity - 1);
+	return &slots[index];
+}
+
+bool hash_grow(hash_table* table){
+	size_t capacity = table->capacity * 2;
+	hash_slot* slots = calloc(capacity, sizeof(hash_slot));
+	if(slots == NULL)
+		return false;
+	for(size_t i = 0; i < table->capacity; i++){
+		if(table->slots[i].is_used)
+			*hash_find_slot(slots, capacity, table->slots[i].key) = table->slots[i];
+	}
+	free(table->slots);
+	table->slots = slots;
+	table->capacity = capacity;
+	return true;
+}
+
+bool hash_insert(void* container, unsigned int key, uintptr_t value){
+	hash_table* table = container;
+	//Keep the load factor at most 1/2:
+	if((table->count + 1) * 2 > table->capacity  &&  !hash_grow(table))
+		return false;
+	hash_slot* slot = hash_find_slot(table->slots, table->capacity, key);
+	if(!slot->is_used){
+		slot->is_used = true;
+		slot->key = key;
+		table->count++;
+	}
+	slot->value = value;
+	return true;
+}
+
+bool hash_get(void* container, unsigned int key, uintptr_t* value){
+	hash_table* table = container;
+	hash_slot* slot = hash_find_slot(table->slots, table->capacity, key);
+	if(!slot->is_used)
+		return false;
+	*value = slot->value;
+	return true;
+}
+
+size_t hash_get_memory_usage(void* container){
+	hash_table* table = container;
+	return sizeof(hash_table) + table->capacity * sizeof(hash_slot);
+}
+
+const container_operations hash_table_container = {
+	"hash", hash_create, hash_destroy, hash_insert, hash_get, NULL, hash_get_memory_usage, NULL
+};
@@ -0,0 +1,46 @@
+#ifndef BASELINES_H
+#define BASELINES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//operations of a container the benchmark runs on, keys map to one value each
+typedef struct{
+	const char* name;
+	//layers and flags are only used by the skip list
+	void* (*create)(unsigned int layers, unsigned int flags);
+	void (*destroy)(void* container);
+	//inserts a key or replaces its value, returns false if there was an error at allocating memory
+	bool (*insert)(void* container, unsigned int key, uintptr_t value);
+	bool (*get)(void* container, unsigned int key, uintptr_t* value);
+	//visits up to count keys from the first key >= key on and adds their values to checksum,
+	//NULL if the container isn't sorted
+	unsigned int (*scan)(void* container, unsigned int key, unsigned int count, uintptr_t* checksum);
+	//bytes allocated by the container
+	size_t (*get_memory_usage)(void* container);
+	//loads keys in any order into an empty container at once, NULL if the load phase uses insert()
+	bool (*load)(void* container, const unsigned int* keys, const uintptr_t* values, unsigned int count);
+}container_operations;
+
+/*****************************************************************/
+/*************************** Containers **************************/
+/*****************************************************************/
+
+//sl_skip_list, updates use sl_upsert()
+extern const container_operations skiplist_container;
+//sorted arrays of keys and values with binary search, insertions move the tail, loading sorts once
+extern const container_operations sorted_array_container;
+//red-black tree with parent pointers
+extern const container_operations red_black_tree_container;
+//B+-tree with linked leaves
+extern const container_operations b_plus_tree_container;
+//open addressing with linear probing, grows at a load factor of 1/2
+extern const container_operations hash_table_container;
+
+#endif /*BASELINES_H*/
@@ -0,0 +1,497 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include "skiplist.h"
+#include "baselines.h"
+
+/*****************************************************************/
+/**************************** Defines ****************************/
+/*****************************************************************/
+
+#define DEFAULT_RECORDS 1000000
+#define DEFAULT_OPERATIONS 1000000
+#define DEFAULT_LAYERS 20
+#define DEFAULT_SEED 42
+//Zipfian constant of YCSB
+#define DEFAULT_THETA 0.99
+//Scans of workload E visit 1 to MAXIMUM_SCAN_LENGTH nodes
+#define MAXIMUM_SCAN_LENGTH 100
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+typedef enum{
+	OPERATION_READ,
+	OPERATION_UPDATE,
+	OPERATION_INSERT,
+	OPERATION_SCAN,
+	OPERATION_READ_MODIFY_WRITE
+}operation_type;
+
+//YCSB core workload, the proportions are percent and add up to 100
+typedef struct{
+	char name;
+	const char* description;
+	unsigned int read_percent;
+	unsigned int update_percent;
+	unsigned int insert_percent;
+	unsigned int scan_percent;
+	unsigned int read_modify_write_percent;
+	//reads prefer the records that were inserted last
+	bool is_reading_latest;
+}workload;
+
+typedef enum{
+	DISTRIBUTION_UNIFORM,
+	DISTRIBUTION_ZIPFIAN,
+	DISTRIBUTION_SEQUENTIAL
+}key_distribution;
+
+//generator of record indices
+typedef struct{
+	key_distribution distribution;
+	uint64_t random_state;
+	//next index of DISTRIBUTION_SEQUENTIAL
+	unsigned int sequence;
+	//zipfian over the records that were loaded, like the ZipfianGenerator of YCSB
+	unsigned int item_count;
+	double theta;
+	double alpha;
+	double zeta_n;
+	double eta;
+}key_generator;
+
+//parameters from the command line
+typedef struct{
+	const container_operations* container;
+	const workload* workload;
+	key_distribution distribution;
+	unsigned int records;
+	unsigned int operations;
+	unsigned int layers;
+	unsigned int flags;
+	unsigned int repetitions;
+	uint64_t seed;
+	double theta;
+	bool is_printing_header;
+}benchmark_options;
+
+//results of one repetition
+typedef struct{
+	double load_seconds;
+	double run_seconds;
+	uint64_t p50_ns;
+	uint64_t p99_ns;
+	uint64_t p999_ns;
+	uint64_t maximum_ns;
+	double bytes_per_record;
+}benchmark_result;
+
+static const workload workloads[] = {
+	{ 'A', "update heavy", 50, 50, 0, 0, 0, false },
+	{ 'B', "read mostly", 95, 5, 0, 0, 0, false },
+	{ 'C', "read only", 100, 0, 0, 0, 0, false },
+	{ 'D', "read latest", 95, 0, 5, 0, 0, true },
+	{ 'E', "short ranges", 0, 0, 5, 95, 0, false },
+	{ 'F', "read-modify-write", 50, 0, 0, 0, 50, false }
+};
+
+static const char* distribution_names[] = { "uniform", "zipfian", "sequential" };
+
+static const container_operations* containers[] = {
+	&skiplist_container, &sorted_array_container, &red_black_tree_container, &b_plus_tree_container, &hash_table_container
+};
+
+/*****************************************************************/
+/************************* Key Generation ************************/
+/*****************************************************************/
+
+uint64_t next_random(uint64_t* state){
+	//xorshift64*:
+	uint64_t x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+double next_uniform_double(uint64_t* state){
+	//53 random bits in [0, 1):
+	return (double)(next_random(state) >> 11) / 9007199254740992.0;
+}
+
+double get_zeta(unsigned int count, double theta){
+	double sum = 0;
+	for(unsigned int i = 1; i <= count; i++)
+		sum += 1.0 / pow((double)i, theta);
+	return sum;
+}
+
+void init_key_generator(key_generator* generator, key_distribution distribution, unsigned int item_count, double theta, uint64_t seed){
+	generator->distribution = distribution;
+	generator->random_state = seed == 0 ? 1 : seed;
+	generator->sequence = 0;
+	generator->item_count = item_count;
+	generator->theta = theta;
+
+	//Constants of "Quickly generating billion-record synthetic databases" (Gray et al.), computed once:
+	if(distribution == DISTRIBUTION_ZIPFIAN){
+		double zeta_2 = get_zeta(2, theta);
+		generator->alpha = 1.0 / (1.0 - theta);
+		generator->zeta_n = get_zeta(item_count, theta);
+		generator->eta = (1.0 - pow(2.0 / item_count, 1.0 - theta)) / (1.0 - zeta_2 / generator->zeta_n);
+	}
+}
+
+//Returns an index in [0, item_count), index 0 is the most popular one with DISTRIBUTION_ZIPFIAN
+unsigned int next_index(key_generator* generator){
+	switch(generator->distribution){
+		case DISTRIBUTION_SEQUENTIAL:
+			return generator->sequence++ % generator->item_count;
+		case DISTRIBUTION_ZIPFIAN:{
+			double u = next_uniform_double(&generator->random_state);
+			double uz = u * generator->zeta_n;
+			if(uz < 1.0)
+				return 0;
+			if(uz < 1.0 + pow(0.5, generator->theta))
+				return 1;
+			unsigned int index = (unsigned int)(generator->item_count * pow(generator->eta * u - generator->eta + 1.0, generator->alpha));
+			return index < generator->item_count ? index : generator->item_count - 1;
+		}
+		default: /* DISTRIBUTION_UNIFORM */
+			return (unsigned int)(next_random(&generator->random_state) % generator->item_count);
+	}
+}
+
+//Turns a record index into its key. Sequential keys stay in order, the others are scrambled, so the popular
+//records of the zipfian distribution are spread over the whole skip list like hashed keys of YCSB
+unsigned int get_key(const benchmark_options* options, unsigned int index){
+	return options->distribution == DISTRIBUTION_SEQUENTIAL ? index : index * 2654435761u;
+}
+
+/*****************************************************************/
+/*************************** Measuring ***************************/
+/*****************************************************************/
+
+uint64_t get_nanoseconds(void){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+}
+
+int compare_latencies(const void* a, const void* b){
+	uint64_t first = *(const uint64_t*)a;
+	uint64_t second = *(const uint64_t*)b;
+	return (first > second) - (first < second);
+}
+
+uint64_t get_percentile(const uint64_t* sorted_latencies, unsigned int count, unsigned int per_mille){
+	unsigned long long position = (unsigned long long)count * per_mille / 1000;
+	return sorted_latencies[position < count ? position : count - 1];
+}
+
+operation_type choose_operation(const workload* workload, uint64_t* random_state){
+	unsigned int choice = (unsigned int)(next_random(random_state) % 100);
+	if(choice < workload->read_percent)
+		return OPERATION_READ;
+	choice -= workload->read_percent;
+	if(choice < workload->update_percent)
+		return OPERATION_UPDATE;
+	choice -= workload->update_percent;
+	if(choice < workload->insert_percent)
+		return OPERATION_INSERT;
+	choice -= workload->insert_percent;
+	if(choice < workload->scan_percent)
+		return OPERATION_SCAN;
+	return OPERATION_READ_MODIFY_WRITE;
+}
+
+/*****************************************************************/
+/************************** Benchmarking *************************/
+/*****************************************************************/
+
+//Loads the records at once with container->load(), like the inserts in index order
+bool load_records(const benchmark_options* options, void* container){
+	unsigned int* keys = malloc(sizeof(unsigned int) * options->records);
+	uintptr_t* values = malloc(sizeof(uintptr_t) * options->records);
+	bool is_loaded = false;
+	if(keys != NULL  &&  values != NULL){
+		for(unsigned int i = 0; i < options->records; i++){
+			keys[i] = get_key(options, i);
+			values[i] = i;
+		}
+		is_loaded = options->container->load(container, keys, values, options->records);
+	}
+	free(keys);
+	free(values);
+	return is_loaded;
+}
+
+bool run_benchmark(const benchmark_options* options, uint64_t seed, benchmark_result* result){
+	const container_operations* operations = options->container;
+	void* container = operations->create(options->layers, options->flags);
+	uint64_t* latencies = malloc(sizeof(uint64_t) * options->operations);
+	if(container == NULL  ||  latencies == NULL){
+		fprintf(stderr, "Error while allocating the %s\n", operations->name);
+		if(container != NULL)
+			operations->destroy(container);
+		free(latencies);
+		return false;
+	}
+	if(operations == &skiplist_container)
+		sl_set_seed(container, seed);
+
+	//Load phase: insert the records in index order, scrambled keys arrive in random order:
+	uint64_t start = get_nanoseconds();
+	bool is_loaded = true;
+	if(operations->load != NULL){
+		//The timing includes filling the arrays, that's small against sorting them:
+		is_loaded = load_records(options, container);
+	}
+	else{
+		for(unsigned int i = 0; i < options->records  &&  is_loaded; i++)
+			is_loaded = operations->insert(container, get_key(options, i), i);
+	}
+	if(!is_loaded){
+		fprintf(stderr, "Error while loading the records\n");
+		operations->destroy(container);
+		free(latencies);
+		return false;
+	}
+	result->load_seconds = (get_nanoseconds() - start) / 1e9;
+
+	key_generator generator;
+	init_key_generator(&generator, options->distribution, options->records, options->theta, seed);
+	uint64_t random_state = seed ^ 0x9E3779B97F4A7C15ULL;
+	unsigned int record_count = options->records;
+	uintptr_t checksum = 0;
+
+	//Run phase, every operation is timed on its own:
+	start = get_nanoseconds();
+	for(unsigned int i = 0; i < options->operations; i++){
+		operation_type operation = choose_operation(options->workload, &random_state);
+		unsigned int index = next_index(&generator);
+		//Workload D reads the records that were inserted last most often:
+		if(options->workload->is_reading_latest)
+			index = record_count - 1 - index % record_count;
+		unsigned int key = get_key(options, index);
+
+		uint64_t operation_start = get_nanoseconds();
+		uintptr_t value;
+		switch(operation){
+			case OPERATION_READ:
+				if(operations->get(container, key, &value))
+					checksum += value;
+				break;
+			case OPERATION_UPDATE:
+				operations->insert(container, key, i);
+				break;
+			case OPERATION_INSERT:
+				operations->insert(container, get_key(options, record_count), record_count);
+				record_count++;
+				break;
+			case OPERATION_SCAN:
+				operations->scan(container, key, 1 + (unsigned int)(next_random(&random_state) % MAXIMUM_SCAN_LENGTH), &checksum);
+				break;
+			case OPERATION_READ_MODIFY_WRITE:
+				if(operations->get(container, key, &value))
+					operations->insert(container, key, value + 1);
+				break;
+		}
+		latencies[i] = get_nanoseconds() - operation_start;
+	}
+	result->run_seconds = (get_nanoseconds() - start) / 1e9;
+	//The keys of the records are distinct, so every record is one entry:
+	result->bytes_per_record = (double)operations->get_memory_usage(container) / record_count;
+
+	qsort(latencies, options->operations, sizeof(uint64_t), compare_latencies);
+	result->p50_ns = get_percentile(latencies, options->operations, 500);
+	result->p99_ns = get_percentile(latencies, options->operations, 990);
+	result->p999_ns = get_percentile(latencies, options->operations, 999);
+	result->maximum_ns = latencies[options->operations - 1];
+
+	//Keeps the reads from being optimized away:
+	if(checksum == 1)
+		fprintf(stderr, "checksum: %lu\n", (unsigned long)checksum);
+
+	free(latencies);
+	operations->destroy(container);
+	return true;
+}
+
+/*****************************************************************/
+/************************* Command Line **************************/
+/*****************************************************************/
+
+void print_usage(const char* program){
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -c, --container NAME           skiplist, array, rbtree, bptree or hash (default skiplist)\n"
+		"                                 hash can't run workload E, layers and flags only apply to skiplist\n"
+		"  -w, --workload A|B|C|D|E|F     YCSB core workload (default A)\n"
+		"                                 A 50%% read 50%% update, B 95%% read 5%% update, C 100%% read,\n"
+		"                                 D 95%% read latest 5%% insert, E 95%% scan 5%% insert,\n"
+		"                                 F 50%% read 50%% read-modify-write\n"
+		"  -d, --distribution NAME        uniform, zipfian or sequential (default uniform)\n"
+		"  -n, --records N                records of the load phase (default %u)\n"
+		"  -o, --operations N             operations of the run phase (default %u)\n"
+		"  -l, --layers N                 layers of the skip list (default %u)\n"
+		"  -f, --flags LIST               comma separated: slabs, dynamic, indexable, successor\n"
+		"  -r, --repetitions N            rows to print, each with a new skip list (default 1)\n"
+		"  -s, --seed N                   seed of heights and keys (default %u)\n"
+		"  -t, --theta X                  zipfian constant (default %.2f)\n"
+		"      --no-header                don't print the CSV header\n"
+		"  -h, --help                     print this help\n",
+		program, DEFAULT_RECORDS, DEFAULT_OPERATIONS, DEFAULT_LAYERS, DEFAULT_SEED, DEFAULT_THETA);
+}
+
+bool parse_flags(const char* list, unsigned int* flags){
+	char copy[256];
+	snprintf(copy, sizeof(copy), "%s", list);
+	*flags = 0;
+	for(char* name = strtok(copy, ","); name != NULL; name = strtok(NULL, ",")){
+		if(strcmp(name, "slabs") == 0)
+			*flags |= SL_USE_SLABS;
+		else if(strcmp(name, "dynamic") == 0)
+			*flags |= SL_DYNAMIC_LAYERS;
+		else if(strcmp(name, "indexable") == 0)
+			*flags |= SL_INDEXABLE;
+		else if(strcmp(name, "successor") == 0)
+			*flags |= SL_SUCCESSOR_KEYS;
+		else if(strcmp(name, "none") != 0)
+			return false;
+	}
+	return true;
+}
+
+bool parse_options(int argc, char** argv, benchmark_options* options){
+	static const struct option long_options[] = {
+		{ "container", required_argument, NULL, 'c' },
+		{ "workload", required_argument, NULL, 'w' },
+		{ "distribution", required_argument, NULL, 'd' },
+		{ "records", required_argument, NULL, 'n' },
+		{ "operations", required_argument, NULL, 'o' },
+		{ "layers", required_argument, NULL, 'l' },
+		{ "flags", required_argument, NULL, 'f' },
+		{ "repetitions", required_argument, NULL, 'r' },
+		{ "seed", required_argument, NULL, 's' },
+		{ "theta", required_argument, NULL, 't' },
+		{ "no-header", no_argument, NULL, 'H' },
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+
+	options->container = &skiplist_container;
+	options->workload = &workloads[0];
+	options->distribution = DISTRIBUTION_UNIFORM;
+	options->records = DEFAULT_RECORDS;
+	options->operations = DEFAULT_OPERATIONS;
+	options->layers = DEFAULT_LAYERS;
+	options->flags = 0;
+	options->repetitions = 1;
+	options->seed = DEFAULT_SEED;
+	options->theta = DEFAULT_THETA;
+	options->is_printing_header = true;
+
+	int option;
+	while((option = getopt_long(argc, argv, "c:w:d:n:o:l:f:r:s:t:h", long_options, NULL)) != -1){
+		switch(option){
+			case 'c':{
+				options->container = NULL;
+				for(size_t i = 0; i < sizeof(containers) / sizeof(containers[0]); i++){
+					if(strcmp(optarg, containers[i]->name) == 0)
+						options->container = containers[i];
+				}
+				if(options->container == NULL)
+					return false;
+				break;
+			}
+			case 'w':{
+				options->workload = NULL;
+				for(size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++){
+					if(optarg[0] != '\0'  &&  optarg[1] == '\0'  &&  (optarg[0] == workloads[i].name  ||  optarg[0] == workloads[i].name + 'a' - 'A'))
+						options->workload = &workloads[i];
+				}
+				if(options->workload == NULL)
+					return false;
+				break;
+			}
+			case 'd':{
+				bool is_known = false;
+				for(int i = 0; i < 3; i++){
+					if(strcmp(optarg, distribution_names[i]) == 0){
+						options->distribution = i;
+						is_known = true;
+					}
+				}
+				if(!is_known)
+					return false;
+				break;
+			}
+			case 'n':
+				options->records = (unsigned int)strtoul(optarg, NULL, 10);
+				break;
+			case 'o':
+				options->operations = (unsigned int)strtoul(optarg, NULL, 10);
+				break;
+			case 'l':
+				options->layers = (unsigned int)strtoul(optarg, NULL, 10);
+				break;
+			case 'f':
+				if(!parse_flags(optarg, &options->flags))
+					return false;
+				break;
+			case 'r':
+				options->repetitions = (unsigned int)strtoul(optarg, NULL, 10);
+				break;
+			case 's':
+				options->seed = strtoull(optarg, NULL, 10);
+				break;
+			case 't':
+				options->theta = strtod(optarg, NULL);
+				break;
+			case 'H':
+				options->is_printing_header = false;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	//Zipfian needs theta in (0, 1), every phase needs at least one record or operation and scans need a sorted container:
+	return optind == argc  &&  options->records > 0  &&  options->operations > 0  &&  options->layers > 0  &&
+		   options->theta > 0  &&  options->theta < 1  &&  (options->workload->scan_percent == 0  ||  options->container->scan != NULL);
+}
+
+int main(int argc, char** argv){
+	benchmark_options options;
+	if(!parse_options(argc, argv, &options)){
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if(options.is_printing_header)
+		printf("container,workload,distribution,records,operations,layers,flags,repetition,load_seconds,load_ops_per_second,"
+			   "run_seconds,ops_per_second,p50_ns,p99_ns,p999_ns,max_ns,bytes_per_record\n");
+
+	for(unsigned int i = 0; i < options.repetitions; i++){
+		benchmark_result result;
+		if(!run_benchmark(&options, options.seed + i, &result))
+			return 1;
+		printf("%s,%c,%s,%u,%u,%u,0x%x,%u,%.6f,%.0f,%.6f,%.0f,%llu,%llu,%llu,%llu,%.2f\n",
+			   options.container->name, options.workload->name, distribution_names[options.distribution], options.records, options.operations,
+			   options.layers, options.flags, i, result.load_seconds, options.records / result.load_seconds,
+			   result.run_seconds, options.operations / result.run_seconds, (unsigned long long)result.p50_ns,
+			   (unsigned long long)result.p99_ns, (unsigned long long)result.p999_ns, (unsigned long long)result.maximum_ns,
+			   result.bytes_per_record);
+		fflush(stdout);
+	}
+	return 0;
+}
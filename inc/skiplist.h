@@ -1,12 +1,48 @@
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************/
+/**************************** Defines ****************************/
+/*****************************************************************/
+
+//Flags of sl_create_custom_skip_list():
+//Nodes are taken from slabs with one size class per height, removed nodes are reused
+#define SL_USE_SLABS 0x1
+//New nodes start at layer 0 only, higher layers are used as soon as the node count grows
+#define SL_DYNAMIC_LAYERS 0x2
+//Every next_in_layer pointer stores how many nodes it jumps over, for sl_rank(), sl_select() and sl_count_range()
+#define SL_INDEXABLE 0x4
+//Every next_in_layer pointer is accompanied by a copy of the next node's key, searches don't touch nodes they skip
+#define SL_SUCCESSOR_KEYS 0x8
+
+//Searches of the histogram of sl_get_stats() are counted by the amount of nodes they moved to, longer searches
+//are counted in the last bucket:
+#define SL_SEARCH_LENGTH_BUCKETS 64
 
 /*****************************************************************/
 /**************************** Structs ****************************/
 /*****************************************************************/
 
-//node
+//counters of a skip list, they're only counted if the library is compiled with SL_STATISTICS (-DSL_STATISTICS)
+typedef struct{
+	unsigned long long insertions;
+	unsigned long long searches;
+	unsigned long long removals;
+	//key comparisons of all searches, against nodes or against successor keys
+	unsigned long long comparisons;
+	//nodes all searches moved to
+	unsigned long long visited_nodes;
+	//search_lengths[i]: searches that moved to i nodes
+	unsigned long long search_lengths[SL_SEARCH_LENGTH_BUCKETS];
+}sl_counters;
+
+//node, next_in_layer holds height + 1 pointers (followed by height + 1 widths with SL_INDEXABLE and height + 1
+//successor keys with SL_SUCCESSOR_KEYS)
 typedef struct _sl_node{
 	unsigned int key;
 	unsigned int height;
@@ -14,13 +50,81 @@ typedef struct _sl_node{
 	struct _sl_node* next_in_layer[];
 }sl_node;
 
+//probability p that a node of height h also gets part of layer h + 1
+typedef enum{
+	SL_P_HALF,
+	SL_P_QUARTER,
+	SL_P_INV_E
+}sl_probability;
+
+//allocator hooks, context is passed to every call
+typedef struct{
+	void* (*allocate)(size_t size, void* context);
+	void (*release)(void* pointer, void* context);
+	void* context;
+}sl_allocator;
+
 //skip list
 typedef struct{
 	sl_node* zero_node;
 	unsigned int layer_count;
+	//highest layer that contains a node behind zero_node, searches start here
+	unsigned int top_layer;
+	//maximum height of nodes with random height, grows with SL_DYNAMIC_LAYERS
+	unsigned int height_limit;
+	unsigned int flags;
+	sl_allocator allocator;
+	//one size class per height, NULL if SL_USE_SLABS isn't set
+	struct _sl_slab_class* slab_classes;
+	size_t allocated_bytes;
+	//state of the random number generator that's used for node heights
+	uint64_t random_state;
+	sl_probability probability;
+	//incremented by every change of the structure
+	unsigned long version;
+#ifdef SL_STATISTICS
+	sl_counters counters;
+#endif /*SL_STATISTICS*/
 	unsigned int node_count_in_layer[];
 }sl_skip_list;
 
+//finger, remembers the last search path in a skip list
+typedef struct{
+	sl_skip_list* skiplist;
+	//version of the skip list the path belongs to
+	unsigned long version;
+	//last node in front of the last searched key for every layer
+	sl_node* path[];
+}sl_finger;
+
+//cursor, points at a node of a skip list or at NULL behind the last node
+typedef struct{
+	sl_skip_list* skiplist;
+	sl_node* node;
+}sl_cursor;
+
+//statistics of sl_get_stats()
+typedef struct{
+	//false if the library was compiled without SL_STATISTICS, all counters are 0 then
+	bool is_counting;
+	sl_counters counters;
+	unsigned int layer_count;
+	//layers above top_layer, they only contain zero_node
+	unsigned int unused_layers;
+	size_t allocated_bytes;
+	//nodes in each of the layer_count layers including zero_node, points into the skip list
+	const unsigned int* node_count_in_layer;
+}sl_stats;
+
+//callback of sl_scan_range() (returns false to stop the scan) and sl_remove_node_range_with()
+typedef bool (*sl_visit_function)(sl_node* node, void* context);
+
+//callback of sl_save(), writes the payload of data into buffer if it fits into size bytes and returns its size
+typedef size_t (*sl_serialize_function)(void* data, void* buffer, size_t size, void* context);
+
+//callback of sl_load(), turns size bytes of a payload back into data and returns false if that failed
+typedef bool (*sl_deserialize_function)(const void* buffer, size_t size, void** data, void* context);
+
 /*****************************************************************/
 /*************************** Functions ***************************/
 /*****************************************************************/
@@ -58,6 +162,30 @@ bool sl_insert_node_static(sl_skip_list* skiplist, unsigned int key, void* data,
  */
 bool sl_insert_node(sl_skip_list* skiplist, unsigned int key, void* data);
 
+/*	This function inserts a node with random height or replaces the data of the existing node with the same key.
+ *	It searches the key once and only allocates if the key is new. The function returns the node that holds key
+ *	afterwards, so it can be modified without another search, or NULL if the allocation failed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist: 	- needs a skip list pointer (look at function create_skip_list()).
+ *		-> key: 		- Identifies a node, an existing node keeps its height.
+ *						- If the key is located in front of the first node (zero_node), zero_node takes the key and
+ *						  the data and its old key and data are moved into a new node.
+ *		-> data:		- needs a pointer to data.
+ */
+sl_node* sl_upsert(sl_skip_list* skiplist, unsigned int key, void* data);
+
+/*	This function returns the node with key like sl_get_node() and inserts a node with random height if the key
+ *	doesn't exist yet. The data of an existing node isn't changed. The function returns NULL if the allocation failed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist: 	- needs a skip list pointer (look at function create_skip_list()).
+ *		-> key: 		- Identifies a node, look at function sl_upsert().
+ *		-> data:		- data of the new node, unused if the key does already exist.
+ *		-> is_inserted:	- NULL or a bool that is set to true if a new node was inserted
+ */
+sl_node* sl_get_or_insert(sl_skip_list* skiplist, unsigned int key, void* data, bool* is_inserted);
+
 /*	This function searches through a skip list and returns a node pointer.
  *	The function returns NULL if it wasn't able to find the node.
  *
@@ -78,6 +206,7 @@ sl_node* sl_get_last_node(sl_skip_list* skiplist);
 
 /*	This function removes a node of a skip list and returns true if the node was found and removed.
  *	It also frees the allocated memory of the node.
+ *	If zero_node is removed, key and data of its successor are moved into zero_node and the successor is freed.
  *	The function returns false if the node doesn't exist in the skip list.
  *
  *	PARAMETERS:
@@ -86,18 +215,31 @@ sl_node* sl_get_last_node(sl_skip_list* skiplist);
  */
 bool sl_remove_node(sl_skip_list* skiplist, unsigned int key);
 
-/*	This function removes all nodes of a skip list in a range and returns true if the node was removed successfully.
- *	It also frees the allocated memory of the nodes.
- *	The function returns false if the node doesn't exit in the skip list.
+/*	This function removes all nodes of a skip list in a range and returns the amount of removed nodes.
+ *	It searches the range once, unlinks the whole run in every layer at once and frees the nodes in one sweep.
+ *	The function returns 0 if no node is located in the range.
+ *	If zero_node is removed, key and data of the first node behind the range are moved into zero_node.
  *
  *	PARAMETERS:
  *		-> skiplist:		- needs a skip list pointer (look at function create_skip_list())
  *		-> minimum_key:		- That's the lowest key that's going to be removed. If this key doesn't exist the
- * 							  functions looks for the next existing node after minimum_key and starts removing
- *							  nodes there until maximum_key.
+ * 							  functions starts removing nodes at the next existing node after minimum_key
+ *							  until maximum_key.
  *		-> maximum_key:		- thats the highest possible key thats going to be removed
  */
-bool sl_remove_node_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key);
+unsigned int sl_remove_node_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key);
+
+/*	This function works like sl_remove_node_range() but passes every removed node to release() before its memory is
+ *	freed, e.g. to free its data. The skip list must not be changed inside of release(), its return value is ignored.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function create_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be removed
+ *		-> maximum_key:		- highest key that's going to be removed
+ *		-> release:			- gets every removed node and context, NULL works like sl_remove_node_range()
+ *		-> context:			- any pointer that's passed to release()
+ */
+unsigned int sl_remove_node_range_with(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_visit_function release, void* context);
 
 
 /*	Thisfunction returns a pointer to a skip list whose members are all zeroed/nulled.
@@ -111,6 +253,55 @@ bool sl_remove_node_range(sl_skip_list* skiplist, unsigned int minimum_key, unsi
  */
 sl_skip_list* sl_create_skip_list(unsigned int amount_of_layers);
 
+/*	This function works like sl_create_skip_list() but allows to choose the flags and the allocator of the skip list.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of skip list
+ *								- recommended: amount_of_layers = log2(amount of nodes)
+ *								- with SL_DYNAMIC_LAYERS: maximum height of the skip list, e.g. 32
+ *		-> flags:				- 0 or a combination of:
+ *								- SL_USE_SLABS: nodes are allocated in slabs, one size class per height.
+ *								  Removed nodes are kept for reuse and the memory is given back when the
+ *								  skip list is removed.
+ *								- SL_DYNAMIC_LAYERS: for unknown amounts of nodes. Random heights start at 0
+ *								  and the highest allowed layer is raised as soon as it holds more than 1/p
+ *								  nodes. Only zero_node has all amount_of_layers layers, other nodes keep
+ *								  the height they got at insertion.
+ *								- SL_INDEXABLE: every node stores the width of its next_in_layer pointers.
+ *								  sl_rank(), sl_select() and sl_count_range() need O(log n) instead of O(n),
+ *								  insertions and removes need to update the widths of all layers.
+ *								- SL_SUCCESSOR_KEYS: every node stores the keys of the nodes its next_in_layer
+ *								  pointers point at. Searches compare against these copies and only load the
+ *								  nodes they move to, at the cost of 4 bytes per layer of a node.
+ *		-> allocator:			- hooks that are used for every allocation of the skip list,
+ *								  NULL uses malloc() and free()
+ */
+sl_skip_list* sl_create_custom_skip_list(unsigned int amount_of_layers, unsigned int flags, const sl_allocator* allocator);
+
+/*	This function sets the seed of the random number generator of a skip list. The same seed and the same
+ *	insertions build the same skip list, so benchmarks can be reproduced.
+ *	Every skip list has its own generator, so skip lists of different threads don't affect each other.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> seed:		- any number, also 0
+ */
+void sl_set_seed(sl_skip_list* skiplist, uint64_t seed);
+
+/*	This function sets the probability p that a node reaches the next higher layer. Nodes that are already
+ *	inserted keep their height.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> probability:	- SL_P_HALF (default), SL_P_QUARTER (less memory, longer searches per layer)
+ *						  or SL_P_INV_E
+ *						- recommended layers: log(amount of nodes) to base 1/p
+ */
+void sl_set_probability(sl_skip_list* skiplist, sl_probability probability);
+
 /*	This function prints the skip list vertically in the console and returns true if it worked correctly.
  *	The function returns false if something went wrong while printing.
  *
@@ -119,9 +310,285 @@ sl_skip_list* sl_create_skip_list(unsigned int amount_of_layers);
  */
 bool sl_display_skip_list(sl_skip_list* skiplist);
 
-/*	This function removes all nodes in a skip list.
+/*	This function removes all nodes of a skip list but keeps the skip list itself.
+ *	When the skip list uses slabs, the slabs are kept and reused by the next insertions.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ */
+void sl_clear_skip_list(sl_skip_list* skiplist);
+
+/*	This function removes all nodes in a skip list and the skip list itself.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ */
+void sl_remove_skip_list(sl_skip_list* skiplist);
+
+/*	This function returns the amount of bytes that are currently allocated by a skip list and its nodes.
  *
  *	PARAMETERS:
  *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
  */
-void sl_remove_skip_list(sl_skip_list* skiplist);
\ No newline at end of file
+size_t sl_get_memory_usage(sl_skip_list* skiplist);
+
+/*	This function fills stats with the counters and the shape of a skip list. The counters are only counted
+ *	if the library is compiled with SL_STATISTICS, otherwise they cost nothing and stay 0. Insertions (also
+ *	upserts), searches (also scans, cursors and batches per key) and removals are counted per call. Every
+ *	search for a key adds its comparisons and the nodes it moved to, and one to the search length histogram.
+ *	The counters are added atomically, so readers that share a lock (e.g. sharded skip lists) count correctly.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> stats:		- gets the statistics, node_count_in_layer is valid as long as the skip list
+ */
+void sl_get_stats(sl_skip_list* skiplist, sl_stats* stats);
+
+/*	This function sets all counters of a skip list to 0, e.g. after loading it and before measuring a workload.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ */
+void sl_reset_stats(sl_skip_list* skiplist);
+
+/*	This function returns a finger for a skip list. A finger remembers the path of its last search, so searches
+ *	with the finger for a key that's close to the last one only need O(log d) steps, d = distance of the keys.
+ *	The path gets invalid as soon as the skip list is changed without the finger, the next search
+ *	with the finger starts at zero_node again then.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ */
+sl_finger* sl_create_finger(sl_skip_list* skiplist);
+
+/*	This function frees the memory of a finger.
+ *
+ *	PARAMETERS:
+ *		-> finger:		- needs a finger pointer (look at function sl_create_finger())
+ */
+void sl_remove_finger(sl_finger* finger);
+
+/*	This function works like sl_get_node() but starts at the path of the last search of finger.
+ *
+ *	PARAMETERS:
+ *		-> finger:		- needs a finger pointer (look at function sl_create_finger())
+ *		-> key:			- Function searches for exactly this key. If no node with this key exists in the
+ *						  skip list it returns NULL.
+ */
+sl_node* sl_get_node_from(sl_finger* finger, unsigned int key);
+
+/*	This function works like sl_insert_node() but starts at the path of the last search of finger.
+ *	Inserting increasing keys one after another needs nearly constant time per key.
+ *
+ *	PARAMETERS:
+ *		-> finger:		- needs a finger pointer (look at function sl_create_finger())
+ *		-> key:			- look at function sl_insert_node()
+ *		-> data:		- needs a pointer to data.
+ */
+bool sl_insert_from(sl_finger* finger, unsigned int key, void* data);
+
+/*	This function works like sl_remove_node() but starts at the path of the last search of finger.
+ *
+ *	PARAMETERS:
+ *		-> finger:		- needs a finger pointer (look at function sl_create_finger())
+ *		-> key:			- function searches for exactly this key and deletes the node
+ */
+bool sl_remove_from(sl_finger* finger, unsigned int key);
+
+/*	This function loads sorted keys into an empty skip list and returns true if all nodes were inserted.
+ *	All layers are built in one pass from left to right without any search, the nodes get random heights.
+ *	The function returns false if the skip list isn't empty, the keys aren't sorted or memory allocation failed.
+ *	When memory allocation failed, the nodes in front of the failed one stay in the skip list.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs an empty skip list pointer (look at function create_skip_list())
+ *		-> keys:		- count keys in strictly increasing order
+ *		-> data:		- count data pointers, data[i] belongs to keys[i]. NULL sets all data pointers to NULL.
+ *		-> count:		- amount of nodes
+ */
+bool sl_bulk_load(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count);
+
+/*	This function works like sl_bulk_load() but the heights are perfectly balanced: every (1/p)-th node reaches
+ *	layer 1, every (1/p)^2-th node layer 2 and so on (1/p rounded, look at sl_set_probability()).
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs an empty skip list pointer (look at function create_skip_list())
+ *		-> keys:		- count keys in strictly increasing order
+ *		-> data:		- count data pointers, data[i] belongs to keys[i]. NULL sets all data pointers to NULL.
+ *		-> count:		- amount of nodes
+ */
+bool sl_bulk_load_balanced(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count);
+
+/*	This function inserts a batch of nodes like sl_insert_node() and returns the amount of inserted nodes.
+ *	Every key continues the search at the path of the previous key, so a sorted batch costs about one
+ *	traversal of the skip list. Keys in any other order are inserted too, but slower.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> keys:		- count keys, recommended in increasing order
+ *		-> data:		- count data pointers, data[i] belongs to keys[i]. NULL sets all data pointers to NULL.
+ *		-> count:		- amount of keys
+ *		-> results:		- NULL or an array of count bools, results[i] is the result of inserting keys[i]
+ */
+unsigned int sl_insert_node_batch(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count, bool* results);
+
+/*	This function searches a batch of keys like sl_get_node() and returns the amount of found nodes.
+ *	Every key continues the search at the path of the previous key, so a sorted batch costs about one
+ *	traversal of the skip list. Keys in any other order are searched too, but slower.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> keys:		- count keys, recommended in increasing order
+ *		-> count:		- amount of keys
+ *		-> nodes:		- an array of count node pointers, nodes[i] is the node with keys[i] or NULL
+ */
+unsigned int sl_get_node_batch(sl_skip_list* skiplist, const unsigned int* keys, unsigned int count, sl_node** nodes);
+
+/*	This function searches a batch of keys like sl_get_node() and returns the amount of found nodes.
+ *	Up to SL_GET_MANY_STREAMS searches are interleaved: each one advances by one node in turn and prefetches
+ *	the node it looks at next, so the cache misses of the searches overlap. Meant for unsorted batches of
+ *	large skip lists, sorted batches are faster with sl_get_node_batch().
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> keys:		- count keys in any order
+ *		-> count:		- amount of keys
+ *		-> nodes:		- an array of count node pointers, nodes[i] is the node with keys[i] or NULL
+ */
+unsigned int sl_get_many(sl_skip_list* skiplist, const unsigned int* keys, unsigned int count, sl_node** nodes);
+
+/*	This function removes a batch of nodes like sl_remove_node() and returns the amount of removed nodes.
+ *	Every key continues the search at the path of the previous key, so a sorted batch costs about one
+ *	traversal of the skip list. Keys in any other order are removed too, but slower.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> keys:		- count keys, recommended in increasing order
+ *		-> count:		- amount of keys
+ *		-> results:		- NULL or an array of count bools, results[i] is the result of removing keys[i]
+ */
+unsigned int sl_remove_node_batch(sl_skip_list* skiplist, const unsigned int* keys, unsigned int count, bool* results);
+
+/*	This function points a cursor at the first node of a skip list. A cursor reads the nodes in place without
+ *	copying them. It gets invalid when the node it points at is removed.
+ *
+ *	PARAMETERS:
+ *		-> cursor:		- needs a cursor pointer, e.g. of a sl_cursor on the stack
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ */
+void sl_cursor_init(sl_cursor* cursor, sl_skip_list* skiplist);
+
+/*	This function points a cursor at the first node whose key is >= key and returns true if there is one.
+ *	The function returns false and makes the cursor invalid if all keys are smaller than key.
+ *
+ *	PARAMETERS:
+ *		-> cursor:		- needs a cursor pointer (look at function sl_cursor_init())
+ *		-> key:			- lowest key the cursor may point at
+ */
+bool sl_cursor_seek(sl_cursor* cursor, unsigned int key);
+
+/*	This function moves a cursor to the next node and returns true if the cursor is still valid.
+ *	The function returns false when the cursor moved behind the last node or was invalid already.
+ *
+ *	PARAMETERS:
+ *		-> cursor:		- needs a cursor pointer (look at function sl_cursor_init())
+ */
+bool sl_cursor_next(sl_cursor* cursor);
+
+/*	This function returns true if a cursor points at a node.
+ *
+ *	PARAMETERS:
+ *		-> cursor:		- needs a cursor pointer (look at function sl_cursor_init())
+ */
+bool sl_cursor_valid(const sl_cursor* cursor);
+
+/*	This function returns the key of the node a cursor points at.
+ *
+ *	WARNING: Only call it when sl_cursor_valid() returns true!
+ *
+ *	PARAMETERS:
+ *		-> cursor:		- needs a valid cursor pointer (look at function sl_cursor_valid())
+ */
+unsigned int sl_cursor_key(const sl_cursor* cursor);
+
+/*	This function returns the data pointer of the node a cursor points at.
+ *
+ *	WARNING: Only call it when sl_cursor_valid() returns true!
+ *
+ *	PARAMETERS:
+ *		-> cursor:		- needs a valid cursor pointer (look at function sl_cursor_valid())
+ */
+void* sl_cursor_data(const sl_cursor* cursor);
+
+/*	This function calls visit() for every node in a range in increasing key order and returns the amount of
+ *	visited nodes. The nodes are visited in place, visit() must not insert or remove nodes.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function create_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be visited
+ *		-> maximum_key:		- highest key that's going to be visited
+ *		-> visit:			- gets every node and context, returns false to stop the scan
+ *		-> context:			- any pointer that's passed to visit()
+ */
+unsigned int sl_scan_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_visit_function visit, void* context);
+
+/*	This function returns the amount of nodes whose key is smaller than key, that's the position (starting at 0)
+ *	of the node with key or the position it would be inserted at.
+ *	It needs O(log n) with SL_INDEXABLE (look at function sl_create_custom_skip_list()) and O(n) without.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> key:			- any key, it doesn't need to exist in the skip list
+ */
+unsigned int sl_rank(sl_skip_list* skiplist, unsigned int key);
+
+/*	This function returns the node at a position (starting at 0 with zero_node) in increasing key order.
+ *	The function returns NULL if the skip list has index or less nodes.
+ *	It needs O(log n) with SL_INDEXABLE (look at function sl_create_custom_skip_list()) and O(n) without.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> index:		- position of the node, e.g. node_count_in_layer[0] / 2 for the median
+ */
+sl_node* sl_select(sl_skip_list* skiplist, unsigned int index);
+
+/*	This function returns the amount of nodes whose key is located in a range.
+ *	It needs O(log n) with SL_INDEXABLE (look at function sl_create_custom_skip_list()) and O(n) without.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function create_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be counted
+ *		-> maximum_key:		- highest key that's going to be counted
+ */
+unsigned int sl_count_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key);
+
+/*	This function writes a skip list to a file and returns false if writing failed. The file holds a header and
+ *	one record per node in increasing key order: key, height and the payload of data. Everything is written in
+ *	large sequential blocks in the byte order of the machine. The skip list supports up to 256 layers.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function create_skip_list())
+ *		-> fd:			- file descriptor that's open for writing, the file is written at its current offset
+ *		-> serialize:	- NULL to save no payloads, otherwise it's called for every node. It gets a buffer of size
+ *						  bytes and returns the size of the payload. If that's larger than size, it's called again
+ *						  with a buffer that's large enough.
+ *		-> context:		- passed to serialize
+ */
+bool sl_save(sl_skip_list* skiplist, int fd, sl_serialize_function serialize, void* context);
+
+/*	This function creates a skip list from a file of sl_save() and returns NULL if the file is invalid or
+ *	reading failed. Every layer is rebuilt in one pass without searches, the nodes keep their heights and the
+ *	skip list gets the layers, flags and probability of the saved one. It uses malloc() and free().
+ *
+ *	PARAMETERS:
+ *		-> fd:			- file descriptor that's open for reading at the start of the file of sl_save()
+ *		-> deserialize:	- NULL to load every data pointer as NULL, otherwise it's called for every payload.
+ *						  If loading fails, the data it returned so far isn't released.
+ *		-> context:		- passed to deserialize
+ */
+sl_skip_list* sl_load(int fd, sl_deserialize_function deserialize, void* context);
+
+#endif /*SKIPLIST_H*/
@@ -0,0 +1,106 @@
+#ifndef SKIPLIST_BLOCKED_H
+#define SKIPLIST_BLOCKED_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//unrolled skip list, every node is a block of up to 16 sorted keys in one cache line
+typedef struct _sl_blocked_skip_list sl_blocked_skip_list;
+
+//callback of sl_blocked_scan_range(), returns false to stop the scan
+typedef bool (*sl_blocked_visit_function)(unsigned int key, void* data, void* context);
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function returns a pointer to an empty blocked skip list. The layers link blocks by their lowest key,
+ *	the last block of a search is searched with SSE2/AVX2 compares (or a loop on other CPUs), so one cache
+ *	line holds 16 keys instead of one. Full blocks are split, sparse blocks are merged with their successor.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of skip list
+ *								- recommended: amount_of_layers = log2(amount of nodes / 8)
+ */
+sl_blocked_skip_list* sl_create_blocked_skip_list(unsigned int amount_of_layers);
+
+/*	This function removes all blocks of a blocked skip list and the skip list itself.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ */
+void sl_remove_blocked_skip_list(sl_blocked_skip_list* skiplist);
+
+/*	This function inserts one key and returns true if insertion was successfull.
+ *	If the key does already exist its data is replaced.
+ *	The function returns false if there was an error at allocating memory.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ *		-> key:			- new key
+ *		-> data:		- pointer to data
+ */
+bool sl_blocked_insert_node(sl_blocked_skip_list* skiplist, unsigned int key, void* data);
+
+/*	This function searches through a blocked skip list and returns true if it found the key.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ *		-> key:			- function searches for exactly this key
+ *		-> data:		- gets the data pointer of the key if it was found, can be NULL
+ */
+bool sl_blocked_get_data(sl_blocked_skip_list* skiplist, unsigned int key, void** data);
+
+/*	This function removes a key of a blocked skip list and returns true if the key was found and removed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ *		-> key:			- function searches for exactly this key and deletes it
+ */
+bool sl_blocked_remove_node(sl_blocked_skip_list* skiplist, unsigned int key);
+
+/*	This function visits all keys in [minimum_key, maximum_key] in ascending order and returns the amount of
+ *	visited keys. The skip list must not be changed inside of visit().
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be visited
+ *		-> maximum_key:		- highest key that's going to be visited
+ *		-> visit:			- gets every key, its data and context, returns false to stop the scan
+ *		-> context:			- any pointer that's passed to visit()
+ */
+unsigned int sl_blocked_scan_range(sl_blocked_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_blocked_visit_function visit, void* context);
+
+/*	This function returns the amount of keys in a blocked skip list.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ */
+unsigned int sl_blocked_get_node_count(sl_blocked_skip_list* skiplist);
+
+/*	This function returns the amount of bytes that are currently allocated by a blocked skip list and its blocks.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ */
+size_t sl_blocked_get_memory_usage(sl_blocked_skip_list* skiplist);
+
+/*	This function sets the seed of the random number generator of a skip list. The same seed and the same
+ *	insertions build the same skip list, so benchmarks can be reproduced.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_blocked_skip_list())
+ *		-> seed:		- any number, also 0
+ */
+void sl_blocked_set_seed(sl_blocked_skip_list* skiplist, uint64_t seed);
+
+#endif /*SKIPLIST_BLOCKED_H*/
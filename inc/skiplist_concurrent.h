@@ -0,0 +1,90 @@
+#ifndef SKIPLIST_CONCURRENT_H
+#define SKIPLIST_CONCURRENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//lock-free skip list, all functions can be called by any amount of threads at the same time
+typedef struct _sl_concurrent_skip_list sl_concurrent_skip_list;
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function returns a pointer to an empty lock-free skip list.
+ *	Nodes are linked with compare-and-swap, removed nodes are marked in their next pointers first and
+ *	freed by epoch based reclamation as soon as no thread can read them anymore (look at skiplist_epoch.h).
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of skip list
+ *								- recommended: amount_of_layers = log2(amount of nodes)
+ */
+sl_concurrent_skip_list* sl_create_concurrent_skip_list(unsigned int amount_of_layers);
+
+/*	This function removes all nodes of a lock-free skip list and the skip list itself.
+ *
+ *	WARNING: No other thread may use the skip list anymore!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_concurrent_skip_list())
+ */
+void sl_remove_concurrent_skip_list(sl_concurrent_skip_list* skiplist);
+
+/*	This function inserts one node with random height in a lock-free skip list and returns true if insertion
+ *	was successfull. If a node with the same key does already exist its data is replaced.
+ *	The function returns false if there was an error at allocating memory.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_concurrent_skip_list())
+ *		-> key:			- key of new node
+ *		-> data:		- pointer to data
+ */
+bool sl_concurrent_insert_node(sl_concurrent_skip_list* skiplist, unsigned int key, void* data);
+
+/*	This function searches through a lock-free skip list and returns true if it found the key.
+ *	Nodes can be freed by other threads at any time, so only the data pointer of the node is returned.
+ *	The search never writes to the skip list.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_concurrent_skip_list())
+ *		-> key:			- function searches for exactly this key
+ *		-> data:		- gets the data pointer of the node if it was found, can be NULL
+ */
+bool sl_concurrent_get_data(sl_concurrent_skip_list* skiplist, unsigned int key, void** data);
+
+/*	This function removes a node of a lock-free skip list and returns true if the node was found and removed.
+ *	If several threads remove the same key at the same time only one of them returns true.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_concurrent_skip_list())
+ *		-> key:			- function searches for exactly this key and deletes the node
+ */
+bool sl_concurrent_remove_node(sl_concurrent_skip_list* skiplist, unsigned int key);
+
+/*	This function returns the amount of nodes in a lock-free skip list.
+ *	While other threads insert or remove nodes the amount is only a snapshot.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_concurrent_skip_list())
+ */
+unsigned int sl_concurrent_get_node_count(sl_concurrent_skip_list* skiplist);
+
+/*	This function sets the seed of the random number generator of the calling thread. Every thread draws the
+ *	heights of the nodes it inserts from its own generator, so the same seed and the same insertions of one
+ *	thread build the same skip list. Threads without a seed get a different one every run.
+ *
+ *	PARAMETERS:
+ *		-> seed:		- any number, also 0
+ */
+void sl_concurrent_set_seed(uint64_t seed);
+
+#endif /*SKIPLIST_CONCURRENT_H*/
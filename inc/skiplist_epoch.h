@@ -0,0 +1,49 @@
+#ifndef SKIPLIST_EPOCH_H
+#define SKIPLIST_EPOCH_H
+
+#include <stdbool.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//retired object, embed it in the object that's going to be freed
+typedef struct _sl_epoch_entry{
+	struct _sl_epoch_entry* next_retired;
+	//frees the object that contains this entry
+	void (*release)(struct _sl_epoch_entry* entry);
+}sl_epoch_entry;
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function starts a critical section of the calling thread. Objects that are retired by any thread
+ *	aren't freed before all threads left the critical sections they were in at that time.
+ *	Critical sections can be nested, they never block.
+ */
+void sl_epoch_enter(void);
+
+/*	This function ends a critical section that was started by sl_epoch_enter().
+ */
+void sl_epoch_exit(void);
+
+/*	This function hands an object that is no longer reachable by new readers to epoch based reclamation.
+ *	release() of entry is called as soon as no thread can still read the object (after two epochs).
+ *
+ *	WARNING: Only call it inside a critical section (look at function sl_epoch_enter())!
+ *
+ *	PARAMETERS:
+ *		-> entry:		- needs the entry that's embedded in the object
+ *		-> release:		- frees the object that contains entry
+ */
+void sl_epoch_retire(sl_epoch_entry* entry, void (*release)(sl_epoch_entry* entry));
+
+/*	This function waits until all threads left the critical sections they were in when it was called and
+ *	frees all objects that were retired before. It's the grace period of RCU.
+ *
+ *	WARNING: Never call it inside a critical section, it would wait forever!
+ */
+void sl_epoch_synchronize(void);
+
+#endif /*SKIPLIST_EPOCH_H*/
@@ -0,0 +1,135 @@
+#ifndef SKIPLIST_MAPPED_H
+#define SKIPLIST_MAPPED_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************/
+/**************************** Defines ****************************/
+/*****************************************************************/
+
+//Highest amount of layers of a mapped skip list, the header keeps one free list per height
+#define SL_MAPPED_MAX_LAYERS 32
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//skip list in a memory-mapped file, nodes are linked by offsets from the start of the mapping
+typedef struct _sl_mapped_skip_list sl_mapped_skip_list;
+
+//callback of sl_mapped_scan_range(), returns false to stop the scan
+typedef bool (*sl_mapped_visit_function)(unsigned int key, uint64_t value, void* context);
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function maps a file that holds a skip list and returns a pointer to it. An empty or missing file is
+ *	initialized with an empty skip list. Opening only checks the header, it needs the same time for every size.
+ *	The skip list lives in the file: nodes are allocated from a bump allocator and free lists inside the
+ *	mapping and link each other by offsets, so the mapping may lie at another address after every open.
+ *	Keys map to 64 bit values because pointers aren't valid after a restart. It isn't thread-safe.
+ *
+ *	The file is mapped privately, changes only reach it through sl_mapped_checkpoint() (or closing). After a
+ *	crash of the process or the system the file holds the state of the last checkpoint: opening replays a
+ *	redo log that a checkpoint committed but couldn't write in place, and cuts off a torn log and everything
+ *	allocated after the checkpoint. A file with a damaged header or a missing end isn't opened.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL the file couldn't be opened, mapped or isn't a mapped skip list!
+ *
+ *	PARAMETERS:
+ *		-> path:				- path of the file, it's created if it doesn't exist
+ *		-> amount_of_layers:	- height of a new skip list, at most SL_MAPPED_MAX_LAYERS. An existing
+ *								  skip list keeps the height it was created with.
+ */
+sl_mapped_skip_list* sl_open_mapped_skip_list(const char* path, unsigned int amount_of_layers);
+
+/*	This function writes all changes to the file like sl_mapped_checkpoint(), unmaps it and frees the handle.
+ *	The function returns false if writing failed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ */
+bool sl_close_mapped_skip_list(sl_mapped_skip_list* skiplist);
+
+/*	This function writes all changes since the last checkpoint to the file and returns false if that failed.
+ *	The changed pages are appended as a redo log with a checksum first, the checkpoint is committed as soon as
+ *	the log is on disk. Then they are written in place and the log is removed. The file holds this state
+ *	after a crash, changes after the last successful checkpoint are lost. If writing in place fails after the
+ *	commit, the log stays: the next checkpoint (and every growth of the file) writes its pages first and fails
+ *	as long as that doesn't succeed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ */
+bool sl_mapped_checkpoint(sl_mapped_skip_list* skiplist);
+
+/*	This function inserts one key and returns true if insertion was successfull.
+ *	If the key does already exist its value is replaced in place.
+ *	The function returns false if the file couldn't be enlarged.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ *		-> key:			- new key
+ *		-> value:		- value that's stored in the file
+ */
+bool sl_mapped_insert_node(sl_mapped_skip_list* skiplist, unsigned int key, uint64_t value);
+
+/*	This function searches through a mapped skip list and returns true if it found the key.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ *		-> key:			- function searches for exactly this key
+ *		-> value:		- gets the value of the key if it was found, can be NULL
+ */
+bool sl_mapped_get_value(sl_mapped_skip_list* skiplist, unsigned int key, uint64_t* value);
+
+/*	This function removes a key of a mapped skip list and returns true if the key was found and removed.
+ *	The node is kept in a free list of its height and reused by later insertions.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ *		-> key:			- function searches for exactly this key and deletes it
+ */
+bool sl_mapped_remove_node(sl_mapped_skip_list* skiplist, unsigned int key);
+
+/*	This function visits all keys in [minimum_key, maximum_key] in ascending order and returns the amount of
+ *	visited keys. The skip list must not be changed inside of visit().
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be visited
+ *		-> maximum_key:		- highest key that's going to be visited
+ *		-> visit:			- gets every key, its value and context, returns false to stop the scan
+ *		-> context:			- any pointer that's passed to visit()
+ */
+unsigned int sl_mapped_scan_range(sl_mapped_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_mapped_visit_function visit, void* context);
+
+/*	This function returns the amount of keys in a mapped skip list.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ */
+unsigned int sl_mapped_get_node_count(sl_mapped_skip_list* skiplist);
+
+/*	This function returns the size of the mapped file in bytes.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ */
+size_t sl_mapped_get_file_size(sl_mapped_skip_list* skiplist);
+
+/*	This function sets the seed of the random number generator of a mapped skip list. The state of the generator
+ *	is stored in the file, so the same seed and the same insertions build the same file.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_open_mapped_skip_list())
+ *		-> seed:		- any number, also 0
+ */
+void sl_mapped_set_seed(sl_mapped_skip_list* skiplist, uint64_t seed);
+
+#endif /*SKIPLIST_MAPPED_H*/
@@ -0,0 +1,96 @@
+#ifndef SKIPLIST_MEMTABLE_H
+#define SKIPLIST_MEMTABLE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//write buffer in front of sorted run files: an active skip list takes the writes, full skip lists are frozen
+//and written to run files by a background thread
+typedef struct _sl_memtable sl_memtable;
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function returns a pointer to a memtable and starts its flush thread. Writes go into an active
+ *	skip list. As soon as it uses flush_threshold bytes it's frozen and a new active skip list takes the
+ *	writes. The flush thread streams layer 0 of every frozen skip list into a new run file in directory:
+ *	a header, the entries in increasing key order and a sparse index with every 64th key. Writers never
+ *	wait for a flush. Keys map to 64 bit values, removed keys are written as tombstones until the runs.
+ *	Runs aren't merged. The runs of earlier memtables in directory are read like own runs and new runs get
+ *	greater numbers, a run file is never overwritten. All functions are thread-safe.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory, reading directory or one of its runs
+ *			 or starting the thread!
+ *
+ *	PARAMETERS:
+ *		-> directory:			- existing directory for the run files run-000000.sl, run-000001.sl, ...
+ *		-> amount_of_layers:	- height of the skip lists, look at function sl_create_skip_list()
+ *		-> flush_threshold:		- bytes of the active skip list (nodes and entries) that freeze it
+ */
+sl_memtable* sl_create_memtable(const char* directory, unsigned int amount_of_layers, size_t flush_threshold);
+
+/*	This function waits until the frozen skip lists are written, stops the flush thread and frees the memtable.
+ *	The active skip list isn't written, call sl_memtable_flush() before to keep it. The run files stay.
+ *
+ *	PARAMETERS:
+ *		-> memtable:	- needs a memtable pointer (look at function sl_create_memtable())
+ */
+void sl_remove_memtable(sl_memtable* memtable);
+
+/*	This function sets the value of a key in the active skip list and returns true if that was successfull.
+ *	The function returns false if there was an error at allocating memory.
+ *
+ *	PARAMETERS:
+ *		-> memtable:	- needs a memtable pointer (look at function sl_create_memtable())
+ *		-> key:			- any key
+ *		-> value:		- new value of key
+ */
+bool sl_memtable_put(sl_memtable* memtable, unsigned int key, uint64_t value);
+
+/*	This function removes a key by writing a tombstone into the active skip list, it hides the key in the
+ *	frozen skip lists and the runs. The function returns false if there was an error at allocating memory.
+ *
+ *	PARAMETERS:
+ *		-> memtable:	- needs a memtable pointer (look at function sl_create_memtable())
+ *		-> key:			- key that's going to be removed
+ */
+bool sl_memtable_delete(sl_memtable* memtable, unsigned int key);
+
+/*	This function returns true if a key has a value. It checks the active skip list, then the frozen skip lists
+ *	and then the runs from new to old, the first entry of the key decides. Runs are read with one pread() of
+ *	at most 64 entries that's found by the sparse index. If a run can't be read the search stops there and
+ *	the function returns false, older runs aren't asked because the unread run may replace their entries.
+ *
+ *	PARAMETERS:
+ *		-> memtable:	- needs a memtable pointer (look at function sl_create_memtable())
+ *		-> key:			- function searches for exactly this key
+ *		-> value:		- gets the value of the key if it was found, can be NULL
+ *		-> is_failed:	- gets true if a run couldn't be read (the key is unknown then), can be NULL
+ */
+bool sl_memtable_get(sl_memtable* memtable, unsigned int key, uint64_t* value, bool* is_failed);
+
+/*	This function freezes the active skip list and waits until all frozen skip lists are written to runs.
+ *	The function returns false if writing a run failed, the frozen skip lists are kept in memory then.
+ *
+ *	PARAMETERS:
+ *		-> memtable:	- needs a memtable pointer (look at function sl_create_memtable())
+ */
+bool sl_memtable_flush(sl_memtable* memtable);
+
+/*	This function returns the amount of run files that were written to directory so far, the runs of earlier
+ *	memtables included. It's the number of the next run file.
+ *
+ *	PARAMETERS:
+ *		-> memtable:	- needs a memtable pointer (look at function sl_create_memtable())
+ */
+unsigned int sl_memtable_get_run_count(sl_memtable* memtable);
+
+#endif /*SKIPLIST_MEMTABLE_H*/
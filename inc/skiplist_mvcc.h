@@ -0,0 +1,148 @@
+#ifndef SKIPLIST_MVCC_H
+#define SKIPLIST_MVCC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//skip list whose nodes keep older versions of their data for snapshots
+typedef struct _sl_mvcc_skip_list sl_mvcc_skip_list;
+
+//point-in-time view of a sl_mvcc_skip_list
+typedef struct _sl_mvcc_snapshot sl_mvcc_snapshot;
+
+//callback of sl_snapshot_scan_range(), returns false to stop the scan
+typedef bool (*sl_mvcc_visit_function)(unsigned int key, void* data, void* context);
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function returns a pointer to an empty multi-version skip list.
+ *	Every insertion or removal adds a new version to the node of its key, readers and snapshots never take a lock
+ *	and writers are serialized by one mutex. Versions that no snapshot can see anymore are freed after a grace
+ *	period (look at skiplist_epoch.h).
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of skip list
+ *								- recommended: amount_of_layers = log2(amount of nodes)
+ */
+sl_mvcc_skip_list* sl_create_mvcc_skip_list(unsigned int amount_of_layers);
+
+/*	This function removes all nodes and versions of a multi-version skip list and the skip list itself.
+ *
+ *	WARNING: No other thread may use the skip list anymore and all snapshots have to be released!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ */
+void sl_remove_mvcc_skip_list(sl_mvcc_skip_list* skiplist);
+
+/*	This function inserts a new version of key and returns true if insertion was successfull.
+ *	Snapshots that were taken before still see the older version or no node at all.
+ *	The function returns false if there was an error at allocating memory.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ *		-> key:			- key of new node
+ *		-> data:		- pointer to data
+ */
+bool sl_mvcc_insert_node(sl_mvcc_skip_list* skiplist, unsigned int key, void* data);
+
+/*	This function removes a node and returns true if the node was found and removed.
+ *	Snapshots that were taken before still see the node.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ *		-> key:			- function searches for exactly this key and deletes the node
+ */
+bool sl_mvcc_remove_node(sl_mvcc_skip_list* skiplist, unsigned int key);
+
+/*	This function searches the newest version of key and returns true if it found the key.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ *		-> key:			- function searches for exactly this key
+ *		-> data:		- gets the data pointer of the node if it was found, can be NULL
+ */
+bool sl_mvcc_get_data(sl_mvcc_skip_list* skiplist, unsigned int key, void** data);
+
+/*	This function returns a snapshot of the current state of a multi-version skip list. Taking a snapshot only
+ *	registers the current version, searches and scans through it see exactly the nodes and data of this moment
+ *	while writers continue.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *			 Release every snapshot (look at function sl_release_snapshot()), older versions are kept until then!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ */
+sl_mvcc_snapshot* sl_snapshot(sl_mvcc_skip_list* skiplist);
+
+/*	This function releases a snapshot, versions that only this snapshot could see get garbage.
+ *
+ *	PARAMETERS:
+ *		-> snapshot:	- needs a snapshot pointer (look at function sl_snapshot())
+ */
+void sl_release_snapshot(sl_mvcc_snapshot* snapshot);
+
+/*	This function works like sl_mvcc_get_data() but searches the version of key that was current when the
+ *	snapshot was taken.
+ *
+ *	PARAMETERS:
+ *		-> snapshot:	- needs a snapshot pointer (look at function sl_snapshot())
+ *		-> key:			- function searches for exactly this key
+ *		-> data:		- gets the data pointer of the node if it was found, can be NULL
+ */
+bool sl_snapshot_get_data(sl_mvcc_snapshot* snapshot, unsigned int key, void** data);
+
+/*	This function visits all nodes with keys in [minimum_key, maximum_key] as they were when the snapshot was
+ *	taken, in ascending order, and returns the amount of visited nodes.
+ *
+ *	WARNING: Memory of removed nodes of any skip list that uses epochs isn't freed while a scan runs, long
+ *			 scans should stop and continue from the last key from time to time.
+ *
+ *	PARAMETERS:
+ *		-> snapshot:		- needs a snapshot pointer (look at function sl_snapshot())
+ *		-> minimum_key:		- lowest key that's going to be visited
+ *		-> maximum_key:		- highest key that's going to be visited
+ *		-> visit:			- gets key and data of every node and context, returns false to stop the scan
+ *		-> context:			- any pointer that's passed to visit()
+ */
+unsigned int sl_snapshot_scan_range(sl_mvcc_snapshot* snapshot, unsigned int minimum_key, unsigned int maximum_key, sl_mvcc_visit_function visit, void* context);
+
+/*	This function frees all versions that no snapshot can see anymore and unlinks removed nodes, it returns the
+ *	amount of freed versions. Insertions and removals call it on their own as soon as there are more old
+ *	versions than half of the node count.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ */
+unsigned int sl_mvcc_collect_garbage(sl_mvcc_skip_list* skiplist);
+
+/*	This function returns the amount of nodes in the current state of a multi-version skip list.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ */
+unsigned int sl_mvcc_get_node_count(sl_mvcc_skip_list* skiplist);
+
+/*	This function sets the seed of the random number generator of a skip list. The same seed and the same
+ *	insertions build the same skip list, so benchmarks can be reproduced.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_mvcc_skip_list())
+ *		-> seed:		- any number, also 0
+ */
+void sl_mvcc_set_seed(sl_mvcc_skip_list* skiplist, uint64_t seed);
+
+#endif /*SKIPLIST_MVCC_H*/
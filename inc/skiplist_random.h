@@ -0,0 +1,78 @@
+#ifndef SKIPLIST_RANDOM_H
+#define SKIPLIST_RANDOM_H
+
+#include <stdint.h>
+#include <time.h>
+
+/*	Random heights of all skip lists of this library. Every skip list (or thread) keeps its own state, these
+ *	functions only advance it. They are no part of the skip list interface.
+ */
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function turns any seed (also 0) into a well mixed state for sl_random_word() with SplitMix64.
+ *
+ *	PARAMETERS:
+ *		-> seed:		- any number, the same seed always gives the same state
+ */
+static inline uint64_t sl_random_state(uint64_t seed){
+	uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+	//xorshift gets stuck at 0:
+	return z != 0 ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+/*	This function returns a seed that differs between skip lists and runs, it's used until a seed is set.
+ *
+ *	PARAMETERS:
+ *		-> address:		- address of the skip list (or of the thread local state) that gets the seed
+ */
+static inline uint64_t sl_random_default_seed(const void* address){
+	return (uint64_t)time(0) ^ ((uint64_t)clock() << 32) ^ (uint64_t)(uintptr_t)address;
+}
+
+/*	This function advances the state with xorshift64* and returns the next random word.
+ *
+ *	PARAMETERS:
+ *		-> state:		- state of sl_random_state(), never 0
+ */
+static inline uint64_t sl_random_word(uint64_t* state){
+	uint64_t x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+static inline unsigned int sl_random_trailing_zeros(uint64_t word){
+#ifdef __GNUC__
+	return word == 0 ? 64 : __builtin_ctzll(word);
+#else
+	unsigned int zeros = 0;
+	while(zeros < 64  &&  (word & 1) == 0){
+		word >>= 1;
+		zeros++;
+	}
+	return zeros;
+#endif /*__GNUC__*/
+}
+
+/*	This function returns a random height with p = 1/2 (height h has the probability 2^-(h+1)), the height
+ *	maximum gets the probability of all greater heights.
+ *
+ *	PARAMETERS:
+ *		-> state:		- state of sl_random_state(), never 0
+ *		-> maximum:		- greatest height that is returned
+ */
+static inline unsigned int sl_random_height(uint64_t* state, unsigned int maximum){
+	//Every trailing zero bit is one layer:
+	unsigned int height = sl_random_trailing_zeros(sl_random_word(state));
+	return height < maximum ? height : maximum;
+}
+
+#endif /*SKIPLIST_RANDOM_H*/
@@ -0,0 +1,119 @@
+#ifndef SKIPLIST_SHARDED_H
+#define SKIPLIST_SHARDED_H
+
+#include "skiplist.h"
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//skip list whose key space is split into ranges, every range is a sl_skip_list with its own lock
+typedef struct _sl_sharded_skip_list sl_sharded_skip_list;
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function returns a pointer to an empty sharded skip list. The key space is split evenly into
+ *	amount_of_shards ranges at first, the ranges are moved as soon as the node counts of the shards get skewed.
+ *	Threads that write to different shards don't contend, searches in the same shard share its lock.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of every shard
+ *								- recommended: amount_of_layers = log2(amount of nodes / amount_of_shards)
+ *		-> amount_of_shards:	- amount of key ranges, e.g. the amount of writing threads
+ *		-> flags:				- flags of every shard (look at function sl_create_custom_skip_list())
+ */
+sl_sharded_skip_list* sl_create_sharded_skip_list(unsigned int amount_of_layers, unsigned int amount_of_shards, unsigned int flags);
+
+/*	This function removes all nodes of a sharded skip list and the skip list itself.
+ *
+ *	WARNING: No other thread may use the skip list anymore!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ */
+void sl_remove_sharded_skip_list(sl_sharded_skip_list* skiplist);
+
+/*	This function inserts one node with random height in the shard of key and returns true if insertion was
+ *	successfull. If a node with the same key does already exist its data is replaced.
+ *	The function returns false if there was an error at allocating memory.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ *		-> key:			- key of new node
+ *		-> data:		- pointer to data
+ */
+bool sl_sharded_insert_node(sl_sharded_skip_list* skiplist, unsigned int key, void* data);
+
+/*	This function searches the shard of key and returns true if it found the key.
+ *	Nodes can be removed by other threads as soon as the shard is unlocked, so only the data pointer is returned.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ *		-> key:			- function searches for exactly this key
+ *		-> data:		- gets the data pointer of the node if it was found, can be NULL
+ */
+bool sl_sharded_get_data(sl_sharded_skip_list* skiplist, unsigned int key, void** data);
+
+/*	This function removes a node of the shard of key and returns true if the node was found and removed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ *		-> key:			- function searches for exactly this key and deletes the node
+ */
+bool sl_sharded_remove_node(sl_sharded_skip_list* skiplist, unsigned int key);
+
+/*	This function works like sl_scan_range() across all shards that overlap the range, in ascending key order.
+ *	Every shard is locked while its nodes are visited, so each shard is seen consistently, but writes to other
+ *	shards can happen between two shards. The skip list must not be changed inside of visit().
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be visited
+ *		-> maximum_key:		- highest key that's going to be visited
+ *		-> visit:			- gets every node and context, returns false to stop the scan
+ *		-> context:			- any pointer that's passed to visit()
+ */
+unsigned int sl_sharded_scan_range(sl_sharded_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_visit_function visit, void* context);
+
+/*	This function works like sl_remove_node_range() across all shards that overlap the range and returns the
+ *	amount of removed nodes. Every shard is locked while its part of the range is removed.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be removed
+ *		-> maximum_key:		- highest key that's going to be removed
+ */
+unsigned int sl_sharded_remove_node_range(sl_sharded_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key);
+
+/*	This function moves the shard boundaries so every shard gets the same amount of nodes and returns true if
+ *	it worked. Insertions call it on their own when one shard holds more than 1.5 times the average, it
+ *	returns true without changes when the shards are balanced already. All shards are locked meanwhile.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ */
+bool sl_rebalance_shards(sl_sharded_skip_list* skiplist);
+
+/*	This function returns the amount of nodes in a sharded skip list.
+ *	While other threads insert or remove nodes the amount is only a snapshot.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ */
+unsigned int sl_sharded_get_node_count(sl_sharded_skip_list* skiplist);
+
+/*	This function returns the amount of nodes in one shard, e.g. to check how evenly the nodes are spread.
+ *	The function returns 0 if the shard doesn't exist.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_sharded_skip_list())
+ *		-> shard:		- index of the shard in key order, starts at 0
+ */
+unsigned int sl_sharded_get_shard_node_count(sl_sharded_skip_list* skiplist, unsigned int shard);
+
+#endif /*SKIPLIST_SHARDED_H*/
@@ -0,0 +1,110 @@
+#ifndef SKIPLIST_SWMR_H
+#define SKIPLIST_SWMR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//skip list with one writing thread and any amount of reading threads that never take a lock
+typedef struct _sl_swmr_skip_list sl_swmr_skip_list;
+
+//callback of sl_swmr_scan_range(), returns false to stop the scan
+typedef bool (*sl_swmr_visit_function)(unsigned int key, void* data, void* context);
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+/*	This function returns a pointer to an empty single writer skip list.
+ *	The writer links a node only after its whole tower is initialized, from layer 0 upwards with release stores,
+ *	and unlinks removed nodes from the top layer downwards. Readers follow the pointers with acquire loads, so
+ *	they never see a half linked tower. Removed nodes are freed after a grace period (look at skiplist_epoch.h).
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of skip list
+ *								- recommended: amount_of_layers = log2(amount of nodes)
+ */
+sl_swmr_skip_list* sl_create_swmr_skip_list(unsigned int amount_of_layers);
+
+/*	This function removes all nodes of a single writer skip list and the skip list itself.
+ *
+ *	WARNING: No other thread may use the skip list anymore!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ */
+void sl_remove_swmr_skip_list(sl_swmr_skip_list* skiplist);
+
+/*	This function inserts one node with random height and returns true if insertion was successfull.
+ *	If a node with the same key does already exist its data is replaced.
+ *	The function returns false if there was an error at allocating memory.
+ *
+ *	WARNING: Only one thread at a time may insert or remove nodes!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ *		-> key:			- key of new node
+ *		-> data:		- pointer to data
+ */
+bool sl_swmr_insert_node(sl_swmr_skip_list* skiplist, unsigned int key, void* data);
+
+/*	This function removes a node and returns true if the node was found and removed.
+ *	Readers that are on the node can still leave it, its memory is freed after all of them are done.
+ *
+ *	WARNING: Only one thread at a time may insert or remove nodes!
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ *		-> key:			- function searches for exactly this key and deletes the node
+ */
+bool sl_swmr_remove_node(sl_swmr_skip_list* skiplist, unsigned int key);
+
+/*	This function searches through a single writer skip list and returns true if it found the key.
+ *	It can be called by any amount of threads while the writer changes the skip list, it never blocks.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ *		-> key:			- function searches for exactly this key
+ *		-> data:		- gets the data pointer of the node if it was found, can be NULL
+ */
+bool sl_swmr_get_data(sl_swmr_skip_list* skiplist, unsigned int key, void** data);
+
+/*	This function visits all nodes with keys in [minimum_key, maximum_key] in ascending order and returns the
+ *	amount of visited nodes. Like sl_swmr_get_data() it never blocks, nodes that are inserted or removed during
+ *	the scan may or may not be visited.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:		- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ *		-> minimum_key:		- lowest key that's going to be visited
+ *		-> maximum_key:		- highest key that's going to be visited
+ *		-> visit:			- gets key and data of every node and context, returns false to stop the scan
+ *		-> context:			- any pointer that's passed to visit()
+ */
+unsigned int sl_swmr_scan_range(sl_swmr_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_swmr_visit_function visit, void* context);
+
+/*	This function returns the amount of nodes in a single writer skip list.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ */
+unsigned int sl_swmr_get_node_count(sl_swmr_skip_list* skiplist);
+
+/*	This function sets the seed of the random number generator of a skip list. The same seed and the same
+ *	insertions build the same skip list, so benchmarks can be reproduced.
+ *	Only the writer may call it.
+ *
+ *	PARAMETERS:
+ *		-> skiplist:	- needs a skip list pointer (look at function sl_create_swmr_skip_list())
+ *		-> seed:		- any number, also 0
+ */
+void sl_swmr_set_seed(sl_swmr_skip_list* skiplist, uint64_t seed);
+
+#endif /*SKIPLIST_SWMR_H*/
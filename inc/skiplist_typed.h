@@ -0,0 +1,235 @@
+#ifndef SKIPLIST_TYPED_H
+#define SKIPLIST_TYPED_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "skiplist_random.h"
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//byte string key, the bytes are copied into the node at insertion
+typedef struct{
+	const unsigned char* bytes;
+	size_t length;
+}sl_bytes;
+
+//comparator of the generic skip list, returns < 0, 0 or > 0 like memcmp()
+typedef int (*sl_compare_function)(const void* key_a, const void* key_b);
+
+/*****************************************************************/
+/**************************** Defines ****************************/
+/*****************************************************************/
+
+/*	SL_DECLARE_TYPED_SKIP_LIST() declares a skip list specialized for one key type, SL_DEFINE_TYPED_SKIP_LIST()
+ *	generates its functions in exactly one source file. The comparison is a macro, so every instantiation inlines
+ *	its own compare loop instead of calling a comparator. The following is generated for name:
+ *
+ *		sl_name_node, sl_name_skip_list
+ *		sl_name_skip_list* sl_create_name_skip_list(unsigned int amount_of_layers)
+ *		void sl_remove_name_skip_list(sl_name_skip_list* skiplist)
+ *		bool sl_name_insert_node(sl_name_skip_list* skiplist, key_type key, void* data)
+ *		sl_name_node* sl_name_get_node(sl_name_skip_list* skiplist, key_type key)
+ *		bool sl_name_remove_node(sl_name_skip_list* skiplist, key_type key)
+ *		void sl_name_set_seed(sl_name_skip_list* skiplist, uint64_t seed)
+ *
+ *	They work like sl_create_skip_list(), sl_remove_skip_list(), sl_insert_node(), sl_get_node(), sl_remove_node()
+ *	and sl_set_seed() (look at skiplist.h), but the nodes are behind a head sentinel and p is 1/2.
+ *
+ *	Instantiations whose COMPARE needs skiplist->compare use SL_DECLARE_TYPED_SKIP_LIST_CORE() and
+ *	SL_DEFINE_TYPED_SKIP_LIST_CORE() instead, they generate everything except sl_create_name_skip_list(). Their
+ *	own constructor calls the private create_name_skip_list(amount_of_layers, compare, key_size).
+ *
+ *	PARAMETERS:
+ *		-> name:		- part of all generated names
+ *		-> key_type:	- type of the keys, passed by value
+ *		-> COMPARE:		- COMPARE(skiplist, a, b) returns < 0, 0 or > 0 like memcmp()
+ *		-> KEY_SIZE:	- KEY_SIZE(skiplist, key) returns the amount of bytes key needs behind the node, e.g. 0
+ *		-> KEY_COPY:	- KEY_COPY(skiplist, key, storage) returns the key that's stored in the node, storage
+ *						  points to KEY_SIZE() bytes behind the node
+ */
+#define SL_DECLARE_TYPED_SKIP_LIST(name, key_type)																\
+	SL_DECLARE_TYPED_SKIP_LIST_CORE(name, key_type)																\
+	sl_##name##_skip_list* sl_create_##name##_skip_list(unsigned int amount_of_layers);
+
+#define SL_DEFINE_TYPED_SKIP_LIST(name, key_type, COMPARE, KEY_SIZE, KEY_COPY)									\
+	SL_DEFINE_TYPED_SKIP_LIST_CORE(name, key_type, COMPARE, KEY_SIZE, KEY_COPY)									\
+																												\
+	sl_##name##_skip_list* sl_create_##name##_skip_list(unsigned int amount_of_layers){							\
+		return create_##name##_skip_list(amount_of_layers, NULL, 0);											\
+	}
+
+#define SL_DECLARE_TYPED_SKIP_LIST_CORE(name, key_type)															\
+	typedef struct _sl_##name##_node{																			\
+		key_type key;																							\
+		void* data;																								\
+		unsigned int height;																					\
+		struct _sl_##name##_node* next_in_layer[];																\
+	}sl_##name##_node;																							\
+																												\
+	typedef struct{																								\
+		sl_##name##_node* head;																					\
+		unsigned int layer_count;																				\
+		unsigned int node_count;																				\
+		uint64_t random_state;																					\
+		/*only used by comparator instantiations:*/																\
+		sl_compare_function compare;																			\
+		size_t key_size;																						\
+	}sl_##name##_skip_list;																						\
+																												\
+	void sl_remove_##name##_skip_list(sl_##name##_skip_list* skiplist);											\
+	bool sl_##name##_insert_node(sl_##name##_skip_list* skiplist, key_type key, void* data);					\
+	sl_##name##_node* sl_##name##_get_node(sl_##name##_skip_list* skiplist, key_type key);						\
+	bool sl_##name##_remove_node(sl_##name##_skip_list* skiplist, key_type key);								\
+	void sl_##name##_set_seed(sl_##name##_skip_list* skiplist, uint64_t seed);
+
+#define SL_DEFINE_TYPED_SKIP_LIST_CORE(name, key_type, COMPARE, KEY_SIZE, KEY_COPY)								\
+	static inline unsigned int get_##name##_height(sl_##name##_skip_list* skiplist){							\
+		return sl_random_height(&skiplist->random_state, skiplist->layer_count - 1);							\
+	}																											\
+																												\
+	/*Searches the last node in front of key in every layer and returns the node behind it in layer 0:*/		\
+	static inline sl_##name##_node* find_##name##_predecessors(sl_##name##_skip_list* skiplist, key_type key,	\
+			sl_##name##_node** update){																			\
+		sl_##name##_node* current_node = skiplist->head;														\
+		for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){				\
+			while(current_node->next_in_layer[current_layer] != NULL											\
+					&&  COMPARE(skiplist, current_node->next_in_layer[current_layer]->key, key) < 0)			\
+				current_node = current_node->next_in_layer[current_layer];										\
+			update[current_layer] = current_node;																\
+		}																										\
+		return current_node->next_in_layer[0];																	\
+	}																											\
+																												\
+	static sl_##name##_skip_list* create_##name##_skip_list(unsigned int amount_of_layers,						\
+			sl_compare_function compare, size_t key_size){														\
+		if(amount_of_layers == 0)																				\
+			return NULL;																						\
+		sl_##name##_skip_list* skiplist = malloc(sizeof(sl_##name##_skip_list));								\
+		if(skiplist == NULL)																					\
+			return NULL;																						\
+		skiplist->head = calloc(1, sizeof(sl_##name##_node) + amount_of_layers * sizeof(sl_##name##_node*));	\
+		if(skiplist->head == NULL){																				\
+			free(skiplist);																						\
+			return NULL;																						\
+		}																										\
+		skiplist->head->height = amount_of_layers - 1;															\
+		skiplist->layer_count = amount_of_layers;																\
+		skiplist->node_count = 0;																				\
+		/*Every skip list gets its own seed, use sl_name_set_seed() for reproducible heights:*/					\
+		skiplist->random_state = sl_random_state(sl_random_default_seed(skiplist));								\
+		skiplist->compare = compare;																			\
+		skiplist->key_size = key_size;																			\
+		return skiplist;																						\
+	}																											\
+																												\
+	void sl_remove_##name##_skip_list(sl_##name##_skip_list* skiplist){											\
+		sl_##name##_node* current_node = skiplist->head;														\
+		while(current_node != NULL){																			\
+			sl_##name##_node* next_node = current_node->next_in_layer[0];										\
+			free(current_node);																					\
+			current_node = next_node;																			\
+		}																										\
+		free(skiplist);																							\
+	}																											\
+																												\
+	bool sl_##name##_insert_node(sl_##name##_skip_list* skiplist, key_type key, void* data){					\
+		sl_##name##_node* update[skiplist->layer_count];														\
+		sl_##name##_node* next_node = find_##name##_predecessors(skiplist, key, update);						\
+																												\
+		/*Replace the data of an existing node:*/																\
+		if(next_node != NULL  &&  COMPARE(skiplist, next_node->key, key) == 0){									\
+			next_node->data = data;																				\
+			return true;																						\
+		}																										\
+																												\
+		/*The key is stored behind the tower if it needs memory:*/												\
+		unsigned int height = get_##name##_height(skiplist);													\
+		size_t tower_size = sizeof(sl_##name##_node) + (height + 1) * sizeof(sl_##name##_node*);				\
+		sl_##name##_node* node = malloc(tower_size + KEY_SIZE(skiplist, key));									\
+		if(node == NULL)																						\
+			return false;																						\
+		node->key = KEY_COPY(skiplist, key, (unsigned char*)node + tower_size);									\
+		node->data = data;																						\
+		node->height = height;																					\
+		for(unsigned int i = 0; i <= height; i++){																\
+			node->next_in_layer[i] = update[i]->next_in_layer[i];												\
+			update[i]->next_in_layer[i] = node;																	\
+		}																										\
+		skiplist->node_count++;																					\
+		return true;																							\
+	}																											\
+																												\
+	sl_##name##_node* sl_##name##_get_node(sl_##name##_skip_list* skiplist, key_type key){						\
+		sl_##name##_node* current_node = skiplist->head;														\
+		for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){				\
+			while(current_node->next_in_layer[current_layer] != NULL){											\
+				int comparison = COMPARE(skiplist, current_node->next_in_layer[current_layer]->key, key);		\
+				if(comparison == 0)																				\
+					return current_node->next_in_layer[current_layer];											\
+				if(comparison > 0)																				\
+					break;																						\
+				current_node = current_node->next_in_layer[current_layer];										\
+			}																									\
+		}																										\
+		return NULL;																							\
+	}																											\
+																												\
+	bool sl_##name##_remove_node(sl_##name##_skip_list* skiplist, key_type key){								\
+		sl_##name##_node* update[skiplist->layer_count];														\
+		sl_##name##_node* node = find_##name##_predecessors(skiplist, key, update);								\
+		if(node == NULL  ||  COMPARE(skiplist, node->key, key) != 0)											\
+			return false;																						\
+		for(unsigned int i = 0; i <= node->height; i++)															\
+			update[i]->next_in_layer[i] = node->next_in_layer[i];												\
+		free(node);																								\
+		skiplist->node_count--;																					\
+		return true;																							\
+	}																											\
+																												\
+	void sl_##name##_set_seed(sl_##name##_skip_list* skiplist, uint64_t seed){									\
+		skiplist->random_state = sl_random_state(seed);															\
+	}
+
+//Compare and copy helpers of the instantiations below:
+#define SL_COMPARE_INTEGERS(skiplist, a, b) (((a) > (b)) - ((a) < (b)))
+#define SL_NO_KEY_SIZE(skiplist, key) 0
+#define SL_KEEP_KEY(skiplist, key, storage) (key)
+
+/*****************************************************************/
+/*************************** Functions ***************************/
+/*****************************************************************/
+
+//32 bit keys like sl_skip_list: sl_create_u32_skip_list(), sl_u32_insert_node(), ...
+SL_DECLARE_TYPED_SKIP_LIST(u32, uint32_t)
+
+//64 bit keys: sl_create_u64_skip_list(), sl_u64_insert_node(), ...
+SL_DECLARE_TYPED_SKIP_LIST(u64, uint64_t)
+
+//byte string keys ordered like memcmp(), shorter keys first if one is a prefix of the other:
+//sl_create_bytes_skip_list(), sl_bytes_insert_node(), ...
+SL_DECLARE_TYPED_SKIP_LIST(bytes, sl_bytes)
+
+//keys of any fixed size that are compared by a callback, only created by sl_create_comparator_skip_list() because
+//it needs the comparator: sl_generic_insert_node(), sl_generic_get_node(), ...
+SL_DECLARE_TYPED_SKIP_LIST_CORE(generic, const void*)
+
+/*	This function returns a pointer to an empty generic skip list, it's the comparator version of the typed
+ *	skip lists above and slower because every comparison is an indirect call.
+ *
+ *	WARNING: Everytime using this function check if it returned NULL.
+ *			 When it returns NULL there was a error at allocating memory or compare is NULL!
+ *
+ *	PARAMETERS:
+ *		-> amount_of_layers:	- height of skip list
+ *								- recommended: amount_of_layers = log2(amount of nodes)
+ *		-> key_size:			- amount of bytes of every key, keys are copied into the nodes
+ *		-> compare:				- gets pointers to two keys and returns < 0, 0 or > 0 like memcmp()
+ */
+sl_generic_skip_list* sl_create_comparator_skip_list(unsigned int amount_of_layers, size_t key_size, sl_compare_function compare);
+
+#endif /*SKIPLIST_TYPED_H*/
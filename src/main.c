@@ -2,12 +2,56 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <time.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/perf_event.h>
 #include "skiplist.h"
+#include "skiplist_concurrent.h"
+#include "skiplist_sharded.h"
+#include "skiplist_swmr.h"
+#include "skiplist_mvcc.h"
+#include "skiplist_typed.h"
+#include "skiplist_blocked.h"
+#include "skiplist_mapped.h"
+#include "skiplist_memtable.h"
 
 //Needed by example:
 #define LAYERS 4
 #define NODES 15
 
+//Needed by benchmarks, every iteration i uses the seed BENCHMARK_SEED + i:
+#define BENCHMARK_SEED 1989
+
+//Build modes of benchmark_build_sl():
+#define BUILD_INSERT 0
+#define BUILD_BULK_LOAD 1
+#define BUILD_BULK_LOAD_BALANCED 2
+
+//Mixed load of benchmark_concurrent(), the rest of the operations are searches:
+#define CONCURRENT_INSERT_PERCENT 10
+#define CONCURRENT_REMOVE_PERCENT 10
+
+//Skip lists of benchmark_concurrent():
+#define CONCURRENT_MUTEX 0
+#define CONCURRENT_LOCK_FREE 1
+#define CONCURRENT_SHARDED 2
+#define CONCURRENT_SHARDS 8
+
+//Key types of benchmark_typed():
+#define TYPED_SL_NODE 0
+#define TYPED_U32 1
+#define TYPED_U64 2
+#define TYPED_COMPARATOR 3
+#define TYPED_BYTES 4
+#define TYPED_BYTES_LENGTH 16
+
 //Data for the example:
 typedef struct{
 	char* name;
@@ -22,10 +66,54 @@ int Example();
 void Benchmark01();
 void Benchmark02();
 void Benchmark03();
+void Benchmark04();
+void Benchmark05();
+void Benchmark06();
+void Benchmark07();
+void Benchmark08();
+void Benchmark09();
+void Benchmark10();
+void Benchmark11();
+void Benchmark12();
+void Benchmark13();
+void Benchmark14();
+void Benchmark15();
+void Benchmark16();
+void Benchmark17();
+void Benchmark18();
+void Benchmark19();
+void Benchmark20();
+void Benchmark21();
+void Benchmark22();
+void Benchmark23();
 
 //Functions used by Benchmarks:
 bool benchmark_insert_search_remove(int layers, unsigned int nodes, int iterations, float factor);
-bool benchmark_build_sl(int layers, unsigned nodes, int iterations);
+bool benchmark_build_sl(int layers, unsigned nodes, int iterations, sl_probability probability, unsigned int flags, int build_mode);
+bool benchmark_churn(int layers, unsigned int nodes, unsigned int operations, unsigned int flags);
+bool benchmark_finger(int layers, unsigned int nodes, int iterations, bool use_finger);
+bool benchmark_batch(int layers, unsigned int nodes, unsigned int batch_size, int iterations, bool use_batch);
+bool benchmark_rank_select(int layers, unsigned int nodes, unsigned int operations, unsigned int flags);
+bool benchmark_concurrent(int layers, unsigned int nodes, unsigned int operations, unsigned int threads, int mode);
+bool benchmark_readers(int layers, unsigned int nodes, unsigned int lookups, unsigned int readers, bool use_swmr);
+bool benchmark_snapshot(int layers, unsigned int nodes, unsigned int scans, bool use_snapshot);
+bool benchmark_typed(int layers, unsigned int nodes, unsigned int lookups, int key_type);
+bool benchmark_blocked(int layers, unsigned int nodes, unsigned int lookups, bool use_blocks);
+bool benchmark_successor_keys(int layers, unsigned int nodes, unsigned int lookups, unsigned int flags);
+bool benchmark_get_many(int layers, unsigned int nodes, unsigned int lookups, unsigned int flags);
+bool benchmark_upsert(int layers, unsigned int nodes, unsigned int operations, bool use_upsert);
+bool benchmark_save_load(int layers, unsigned int nodes);
+size_t serialize_value(void* data, void* buffer, size_t size, void* context);
+bool deserialize_value(const void* buffer, size_t size, void** data, void* context);
+bool benchmark_mapped(int layers, unsigned int nodes, unsigned int lookups);
+bool benchmark_memtable(int layers, unsigned int writes, unsigned int lookups, size_t flush_threshold);
+bool benchmark_stats(int layers, unsigned int nodes, unsigned int lookups, sl_probability probability, unsigned int flags);
+bool benchmark_skewed_shards(int layers, unsigned int nodes, unsigned int shards);
+bool benchmark_mapped_recovery(int layers, unsigned int nodes);
+bool has_mapped_keys(sl_mapped_skip_list* skiplist, unsigned int nodes);
+int start_cache_miss_counter();
+long long stop_cache_miss_counter(int counter);
+void print_cache_misses(long long cache_misses, unsigned int lookups);
 
 int main(void){
 	Example();
@@ -132,28 +220,48 @@ void Benchmark01(){
 }
 
 void Benchmark02(){
-	//Compare build time of 4 skip lists with a different amount of layers:
+	//Compare build time of 5 skip lists with a different amount of layers, 2 bulk loaded skip lists and an indexable skip list:
 
 	printf("\n--- Compare time for building up skiplists with a different amount of layers\n\n");
 
 	//Skip list 0 with 10 layers (not recommended):
 	printf("Skip List 0:\n");
-	benchmark_build_sl(10, 10000, 1000);
+	benchmark_build_sl(10, 10000, 1000, SL_P_HALF, 0, BUILD_INSERT);
 	printf("\n\n");
 
 	//Skip list 1 with log2(10000) approx 13 layers (recommended):
 	printf("Skip List 1:\n");
-	benchmark_build_sl(13, 10000, 1000);
+	benchmark_build_sl(13, 10000, 1000, SL_P_HALF, 0, BUILD_INSERT);
 	printf("\n\n");
 
 	//Skip list 2 with 30 layers (not recommended):
 	printf("Skip List 2:\n");
-	benchmark_build_sl(30, 10000, 1000);
+	benchmark_build_sl(30, 10000, 1000, SL_P_HALF, 0, BUILD_INSERT);
 	printf("\n\n");
 
 	//Skip list 3 with 100 layers (not recommended):
 	printf("Skip List 3:\n");
-	benchmark_build_sl(100, 10000, 1000);
+	benchmark_build_sl(100, 10000, 1000, SL_P_HALF, 0, BUILD_INSERT);
+	printf("\n\n");
+
+	//Skip list 4 with up to 32 layers that are used as the skip list grows:
+	printf("Skip List 4 (dynamic layers):\n");
+	benchmark_build_sl(32, 10000, 1000, SL_P_HALF, SL_DYNAMIC_LAYERS, BUILD_INSERT);
+	printf("\n\n");
+
+	//Skip list 5 with 13 layers that's loaded from a sorted array:
+	printf("Skip List 5 (bulk load):\n");
+	benchmark_build_sl(13, 10000, 1000, SL_P_HALF, 0, BUILD_BULK_LOAD);
+	printf("\n\n");
+
+	//Skip list 6 with 13 layers that's loaded from a sorted array with balanced heights:
+	printf("Skip List 6 (balanced bulk load):\n");
+	benchmark_build_sl(13, 10000, 1000, SL_P_HALF, 0, BUILD_BULK_LOAD_BALANCED);
+	printf("\n\n");
+
+	//Skip list 7 with 13 layers that stores the width of every pointer:
+	printf("Skip List 7 (indexable):\n");
+	benchmark_build_sl(13, 10000, 1000, SL_P_HALF, SL_INDEXABLE, BUILD_INSERT);
 }
 
 void Benchmark03(){
@@ -176,12 +284,356 @@ void Benchmark03(){
 	benchmark_insert_search_remove(13, 1000000, 100, 0.8);
 }
 
+void Benchmark04(){
+	//Compare remove/insert churn of a skip list that uses malloc() and a skip list that uses slabs:
+
+	printf("--- Compare churn of skip lists with and without slabs\n\n");
+
+	//Skip list 1 with malloc() and free():
+	printf("Skip List 1 (malloc):\n");
+	benchmark_churn(17, 100000, 1000000, 0);
+	printf("\n\n");
+
+	//Skip list 2 with slabs:
+	printf("Skip List 2 (slabs):\n");
+	benchmark_churn(17, 100000, 1000000, SL_USE_SLABS);
+}
+
+void Benchmark05(){
+	//Compare build time of skip lists with a different probability p, the layers are log(10000) to base 1/p:
+
+	printf("--- Compare time for building up skiplists with a different probability p\n\n");
+
+	//Skip list 1 with p = 1/2:
+	printf("Skip List 1 (p = 1/2):\n");
+	benchmark_build_sl(13, 10000, 1000, SL_P_HALF, 0, BUILD_INSERT);
+	printf("\n\n");
+
+	//Skip list 2 with p = 1/4:
+	printf("Skip List 2 (p = 1/4):\n");
+	benchmark_build_sl(7, 10000, 1000, SL_P_QUARTER, 0, BUILD_INSERT);
+	printf("\n\n");
+
+	//Skip list 3 with p = 1/e:
+	printf("Skip List 3 (p = 1/e):\n");
+	benchmark_build_sl(9, 10000, 1000, SL_P_INV_E, 0, BUILD_INSERT);
+}
+
+void Benchmark06(){
+	//Compare sequential build time and clustered search time without and with a finger:
+
+	printf("--- Compare skip lists without and with a finger\n\n");
+
+	//Skip list 1 that's always searched from zero_node:
+	printf("Skip List 1 (no finger):\n");
+	benchmark_finger(17, 100000, 100, false);
+	printf("\n\n");
+
+	//Skip list 2 that's searched from the last path:
+	printf("Skip List 2 (finger):\n");
+	benchmark_finger(17, 100000, 100, true);
+}
+
+void Benchmark07(){
+	//Compare sorted batches of insertions/searches/removes with single calls:
+
+	printf("--- Compare sorted batches with single calls\n\n");
+
+	//Skip list 1 with single calls:
+	printf("Skip List 1 (single calls):\n");
+	benchmark_batch(20, 1000000, 10000, 100, false);
+	printf("\n\n");
+
+	//Skip list 2 with batches:
+	printf("Skip List 2 (batches):\n");
+	benchmark_batch(20, 1000000, 10000, 100, true);
+}
+
+void Benchmark08(){
+	//Compare rank/select/count time of a skip list without and with widths:
+
+	printf("--- Compare rank, select and count of skip lists without and with widths\n\n");
+
+	//Skip list 1 that walks through layer 0:
+	printf("Skip List 1 (not indexable):\n");
+	benchmark_rank_select(17, 100000, 1000, 0);
+	printf("\n\n");
+
+	//Skip list 2 that stores the width of every pointer:
+	printf("Skip List 2 (indexable):\n");
+	benchmark_rank_select(17, 100000, 1000, SL_INDEXABLE);
+}
+
+void Benchmark09(){
+	//Compare the throughput of a lock-free skip list with a skip list behind one mutex for 1 to 8 threads:
+
+	printf("--- Compare a lock-free skip list with a locked skip list under a mixed load\n\n");
+
+	for(unsigned int threads = 1; threads <= 8; threads *= 2){
+		//Skip list 1 that serializes all threads:
+		printf("Skip List 1 (mutex, %u threads):\n", threads);
+		benchmark_concurrent(20, 500000, 1000000, threads, CONCURRENT_MUTEX);
+		printf("\n\n");
+
+		//Skip list 2 that's lock-free:
+		printf("Skip List 2 (lock-free, %u threads):\n", threads);
+		benchmark_concurrent(20, 500000, 1000000, threads, CONCURRENT_LOCK_FREE);
+		printf("\n\n");
+	}
+}
+
+void Benchmark10(){
+	//Compare the throughput of a sharded skip list with a skip list behind one mutex for 1 to 8 threads:
+
+	printf("--- Compare a sharded skip list with a locked skip list under a mixed load\n\n");
+
+	for(unsigned int threads = 1; threads <= 8; threads *= 2){
+		//Skip list 1 that serializes all threads:
+		printf("Skip List 1 (mutex, %u threads):\n", threads);
+		benchmark_concurrent(20, 500000, 1000000, threads, CONCURRENT_MUTEX);
+		printf("\n\n");
+
+		//Skip list 2 with one lock per key range:
+		printf("Skip List 2 (%d shards, %u threads):\n", CONCURRENT_SHARDS, threads);
+		benchmark_concurrent(17, 500000, 1000000, threads, CONCURRENT_SHARDED);
+		printf("\n\n");
+	}
+}
+
+void Benchmark11(){
+	//Compare the lookup throughput of readers while one writer changes the skip list for 1 to 8 readers:
+
+	printf("--- Compare a single writer skip list with a skip list behind a readers-writer lock\n\n");
+
+	for(unsigned int readers = 1; readers <= 8; readers *= 2){
+		//Skip list 1 whose readers share a lock with the writer:
+		printf("Skip List 1 (rwlock, %u readers):\n", readers);
+		benchmark_readers(20, 500000, 1000000, readers, false);
+		printf("\n\n");
+
+		//Skip list 2 whose readers take no lock:
+		printf("Skip List 2 (single writer, %u readers):\n", readers);
+		benchmark_readers(20, 500000, 1000000, readers, true);
+		printf("\n\n");
+	}
+}
+
+void Benchmark12(){
+	//Compare full scans that lock out the writer with scans of snapshots while the writer continues:
+
+	printf("--- Compare scans of a locked skip list with scans of snapshots\n\n");
+
+	//Skip list 1 whose scans hold the lock of the writer:
+	printf("Skip List 1 (mutex):\n");
+	benchmark_snapshot(20, 500000, 20, false);
+	printf("\n\n");
+
+	//Skip list 2 whose scans see snapshots:
+	printf("Skip List 2 (snapshots):\n");
+	benchmark_snapshot(20, 500000, 20, true);
+}
+
+void Benchmark13(){
+	//Compare skip lists that are specialized for their key type with a skip list that calls a comparator:
+
+	printf("--- Compare specialized key types with a comparator callback\n\n");
+
+	//Skip list 1 is the sl_skip_list with unsigned int keys:
+	printf("Skip List 1 (sl_node):\n");
+	benchmark_typed(20, 1000000, 1000000, TYPED_SL_NODE);
+	printf("\n\n");
+
+	//Skip list 2 with 32 bit keys:
+	printf("Skip List 2 (u32):\n");
+	benchmark_typed(20, 1000000, 1000000, TYPED_U32);
+	printf("\n\n");
+
+	//Skip list 3 with 64 bit keys:
+	printf("Skip List 3 (u64):\n");
+	benchmark_typed(20, 1000000, 1000000, TYPED_U64);
+	printf("\n\n");
+
+	//Skip list 4 with 64 bit keys that calls a comparator:
+	printf("Skip List 4 (u64 comparator):\n");
+	benchmark_typed(20, 1000000, 1000000, TYPED_COMPARATOR);
+	printf("\n\n");
+
+	//Skip list 5 with byte string keys:
+	printf("Skip List 5 (%d byte keys):\n", TYPED_BYTES_LENGTH);
+	benchmark_typed(20, 1000000, 1000000, TYPED_BYTES);
+}
+
+void Benchmark14(){
+	//Compare the time and the cache misses per search of skip lists with one key per node and 16 keys per node
+	//with the sizes of Benchmark03():
+
+	printf("--- Compare skip lists with one key per node and blocks of keys\n\n");
+
+	unsigned int sizes[] = { 10000, 100000, 1000000 };
+	for(int i = 0; i < 3; i++){
+		//Skip list 1 with one key per node:
+		printf("Skip List 1 (sl_node, %u nodes):\n", sizes[i]);
+		benchmark_blocked(20, sizes[i], 1000000, false);
+		printf("\n\n");
+
+		//Skip list 2 with blocks of keys:
+		printf("Skip List 2 (blocks, %u nodes):\n", sizes[i]);
+		benchmark_blocked(17, sizes[i], 1000000, true);
+		printf("\n\n");
+	}
+}
+
+void Benchmark15(){
+	//Compare searches with and without copies of the next keys, cache misses are read from the hardware counters:
+
+	printf("--- Compare skip lists with and without successor keys\n\n");
+
+	unsigned int sizes[] = { 10000, 100000, 1000000 };
+	for(int i = 0; i < 3; i++){
+		//Skip list 1 compares with the keys of the next nodes:
+		printf("Skip List 1 (no flags, %u nodes):\n", sizes[i]);
+		benchmark_successor_keys(20, sizes[i], 1000000, 0);
+		printf("\n\n");
+
+		//Skip list 2 compares with the copies:
+		printf("Skip List 2 (SL_SUCCESSOR_KEYS, %u nodes):\n", sizes[i]);
+		benchmark_successor_keys(20, sizes[i], 1000000, SL_SUCCESSOR_KEYS);
+		printf("\n\n");
+	}
+}
+
+void Benchmark16(){
+	//Compare a loop of sl_get_node() with the interleaved searches of sl_get_many() for unsorted keys:
+
+	printf("--- Compare sl_get_node() in a loop and sl_get_many()\n\n");
+
+	unsigned int sizes[] = { 1000000, 10000000 };
+	for(int i = 0; i < 2; i++){
+		//Skip list 1 compares with the keys of the next nodes:
+		printf("Skip List 1 (no flags, %u nodes):\n", sizes[i]);
+		benchmark_get_many(24, sizes[i], 1000000, 0);
+		printf("\n\n");
+
+		//Skip list 2 compares with the copies:
+		printf("Skip List 2 (SL_SUCCESSOR_KEYS, %u nodes):\n", sizes[i]);
+		benchmark_get_many(24, sizes[i], 1000000, SL_SUCCESSOR_KEYS);
+		printf("\n\n");
+	}
+}
+
+void Benchmark17(){
+	//Compare writes of which half are updates of existing keys with sl_insert_node() and sl_upsert():
+
+	printf("--- Compare sl_insert_node() and sl_upsert() with 50%% updates\n\n");
+
+	//Skip list 1 allocates a new node for every update:
+	printf("Skip List 1 (sl_insert_node()):\n");
+	benchmark_upsert(20, 1000000, 2000000, false);
+	printf("\n\n");
+
+	//Skip list 2 replaces the data in place:
+	printf("Skip List 2 (sl_upsert()):\n");
+	benchmark_upsert(20, 1000000, 2000000, true);
+	printf("\n\n");
+}
+
+void Benchmark18(){
+	//Compare rebuilding a skip list by insertions with saving and loading it:
+
+	printf("--- Compare sl_insert_node() with sl_save() and sl_load()\n\n");
+
+	unsigned int sizes[] = { 1000000, 10000000 };
+	for(int i = 0; i < 2; i++){
+		printf("Skip List (%u nodes):\n", sizes[i]);
+		benchmark_save_load(24, sizes[i]);
+		printf("\n\n");
+	}
+}
+
+void Benchmark19(){
+	//Reopen memory-mapped skip lists of different sizes, opening shouldn't depend on the size:
+
+	printf("--- Reopen memory-mapped skip lists\n\n");
+
+	unsigned int sizes[] = { 10000, 100000, 1000000 };
+	for(int i = 0; i < 3; i++){
+		printf("Skip List (mapped, %u nodes):\n", sizes[i]);
+		benchmark_mapped(20, sizes[i], 1000000);
+		printf("\n\n");
+	}
+}
+
+void Benchmark20(){
+	//Write through memtables with different flush thresholds and read the merged result:
+
+	printf("--- Compare memtables with different flush thresholds\n\n");
+
+	size_t thresholds[] = { 1 << 20, 8 << 20, 64 << 20 };
+	for(int i = 0; i < 3; i++){
+		printf("Memtable (flush at %zu MiB):\n", thresholds[i] >> 20);
+		benchmark_memtable(20, 2000000, 1000000, thresholds[i]);
+		printf("\n\n");
+	}
+}
+
+void Benchmark21(){
+	//Look inside skip lists with sl_get_stats(), the counters need the build with SL_STATISTICS (make STATISTICS=1):
+
+	printf("--- Compare the statistics of skip lists with different probabilities\n\n");
+
+	unsigned int sizes[] = { 100000, 1000000 };
+	for(int i = 0; i < 2; i++){
+		//Skip list 1 uses p = 1/2:
+		printf("Skip List 1 (SL_P_HALF, %u nodes):\n", sizes[i]);
+		benchmark_stats(24, sizes[i], 1000000, SL_P_HALF, 0);
+		printf("\n\n");
+
+		//Skip list 2 uses p = 1/4:
+		printf("Skip List 2 (SL_P_QUARTER, %u nodes):\n", sizes[i]);
+		benchmark_stats(24, sizes[i], 1000000, SL_P_QUARTER, 0);
+		printf("\n\n");
+
+		//Skip list 3 compares with the copies of the next keys:
+		printf("Skip List 3 (SL_P_HALF, SL_SUCCESSOR_KEYS, %u nodes):\n", sizes[i]);
+		benchmark_stats(24, sizes[i], 1000000, SL_P_HALF, SL_SUCCESSOR_KEYS);
+		printf("\n\n");
+	}
+}
+
+void Benchmark22(){
+	//Insert ascending keys that all fall into the first key range, the shards have to rebalance on their own:
+
+	printf("--- Skewed insertions into sharded skip lists\n\n");
+
+	unsigned int shards[] = { 2, 4, 8 };
+	for(int i = 0; i < 3; i++){
+		printf("Skip List (%u shards):\n", shards[i]);
+		benchmark_skewed_shards(20, 1000000, shards[i]);
+		printf("\n\n");
+	}
+}
+
+void Benchmark23(){
+	//Crash a process between checkpoints, tear its redo log, corrupt and truncate the file, every reopen has to
+	//return the last checkpoint or fail:
+
+	printf("--- Recover memory-mapped skip lists after crashes\n\n");
+
+	unsigned int sizes[] = { 1000, 100000 };
+	for(int i = 0; i < 2; i++){
+		printf("Skip List (mapped, %u nodes):\n", sizes[i]);
+		benchmark_mapped_recovery(20, sizes[i]);
+		printf("\n\n");
+	}
+}
+
 bool benchmark_insert_search_remove(int layers, unsigned int nodes, int iterations, float factor){
 
 	double summed_insertion_time = 0;
 	double summed_searching_time = 0;
 	double summed_removing_time = 0;
 	unsigned summed_unused_layers = 0;
+	double summed_memory_per_node = 0;
 	
 	//Duplicate nodes because the skiplist gets only filled with odd keys:
 	nodes *= 2;
@@ -194,6 +646,7 @@ bool benchmark_insert_search_remove(int layers, unsigned int nodes, int iteratio
 
 		//Create skiplist:
 		sl_skip_list *skp = sl_create_skip_list(layers);
+		sl_set_seed(skp, BENCHMARK_SEED + i);
 
 		//Insertion of nodes with odd keys:
 		for(int j = 1; j <= nodes; j += 2){
@@ -204,11 +657,12 @@ bool benchmark_insert_search_remove(int layers, unsigned int nodes, int iteratio
 		}
 
 		//Information about which layers are unused:
-		int curr_layer = layers - 1;
-		while(skp->zero_node->next_in_layer[curr_layer] == NULL){
-			summed_unused_layers++;
-			curr_layer--;
-		}
+		sl_stats stats;
+		sl_get_stats(skp, &stats);
+		summed_unused_layers += stats.unused_layers;
+
+		//Information about the memory that's used per node:
+		summed_memory_per_node += (double)sl_get_memory_usage(skp) / (double)(nodes / 2);
 
 		//Benchmarking of one insertion:
 		clock_t start = clock();
@@ -247,12 +701,15 @@ bool benchmark_insert_search_remove(int layers, unsigned int nodes, int iteratio
 	double average_insertion_time = summed_insertion_time / (double)iterations;
 	double average_searching_time = summed_searching_time / (double)iterations;
 	double average_removing_time = summed_removing_time / (double)iterations;
+	double average_memory_per_node = summed_memory_per_node / (double)iterations;
 
 	printf("\twanted key:\t\t\t%d\n", wanted_key);
 	printf("\titerations:\t\t\t%d\n", iterations);
 	printf("\tnodes:\t\t\t\t%d\n", nodes/2);
 	printf("\tlayers:\t\t\t\t%d\n", layers);
 	printf("\taverage unused layers:\t\t%lf\n", average_unused_layers);
+	printf("\taverage memory per node:\t%.2lf bytes\n", average_memory_per_node);
+	printf("\tmemory per full height node:\t%zu bytes\n", sizeof(sl_node) + sizeof(sl_node*) * layers);
 	printf("\n");
 	printf("\taverage time for insertion:\t%.2lf μs\n", average_insertion_time);
 	printf("\taverage time for searching:\t%.2lf μs\n", average_searching_time);
@@ -261,43 +718,1602 @@ bool benchmark_insert_search_remove(int layers, unsigned int nodes, int iteratio
 	return true;
 }
 
-bool benchmark_build_sl(int layers, unsigned nodes, int iterations){
+bool benchmark_build_sl(int layers, unsigned nodes, int iterations, sl_probability probability, unsigned int flags, int build_mode){
 	double summed_build_time = 0;
 	unsigned summed_unused_layers = 0;
+	double summed_memory_per_node = 0;
+
+	//Sorted keys for the bulk loads:
+	unsigned int *keys = malloc(sizeof(unsigned int) * nodes);
+	if(keys == NULL){
+		printf("Error while allocating the keys\n");
+		return false;
+	}
+	for(int j = 0; j < nodes; j++)
+		keys[j] = j + 1;
 
 	for(int i = 0; i < iterations; i++){
 		clock_t start = clock();
 		//Create skiplist:
-		sl_skip_list *skp = sl_create_skip_list(layers);
+		sl_skip_list *skp = sl_create_custom_skip_list(layers, flags, NULL);
+		sl_set_seed(skp, BENCHMARK_SEED + i);
+		sl_set_probability(skp, probability);
 
 		//Insertion of nodes:
-		for(int j = 1; j <= nodes; j++){
-			if(!sl_insert_node(skp, j, NULL)){
-				printf("Error while building up the whole skiplist\n");
+		if(build_mode == BUILD_BULK_LOAD  ||  build_mode == BUILD_BULK_LOAD_BALANCED){
+			if(!(build_mode == BUILD_BULK_LOAD ? sl_bulk_load : sl_bulk_load_balanced)(skp, keys, NULL, nodes)){
+				printf("Error while loading the whole skiplist\n");
 				return false;
 			}
 		}
+		else{
+			for(int j = 1; j <= nodes; j++){
+				if(!sl_insert_node(skp, j, NULL)){
+					printf("Error while building up the whole skiplist\n");
+					return false;
+				}
+			}
+		}
 
 		summed_build_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
 
 		//Information about which layers are unused:
-		int curr_layer = layers - 1;
-		while(skp->zero_node->next_in_layer[curr_layer] == NULL){
-			summed_unused_layers++;
-			curr_layer--;
-		}
+		sl_stats stats;
+		sl_get_stats(skp, &stats);
+		summed_unused_layers += stats.unused_layers;
+
+		//Information about the memory that's used per node:
+		summed_memory_per_node += (double)sl_get_memory_usage(skp) / (double)nodes;
 
 		sl_remove_skip_list(skp);
 	}
+	free(keys);
 
 	double average_build_time = summed_build_time / (double)iterations;
 	double average_unused_layers = (double)summed_unused_layers / (double)iterations;
+	double average_memory_per_node = summed_memory_per_node / (double)iterations;
 
 	printf("\titerations:\t\t\t%d\n", iterations);
 	printf("\tnodes:\t\t\t\t%d\n", nodes);
 	printf("\tlayers:\t\t\t\t%d\n", layers);
 	printf("\taverage unused layers:\t\t%lf\n", average_unused_layers);
+	printf("\taverage memory per node:\t%.2lf bytes\n", average_memory_per_node);
+	printf("\tmemory per full height node:\t%zu bytes\n", sizeof(sl_node) + sizeof(sl_node*) * layers);
 	printf("\taverage time for building:\t%.2lf μs\n", average_build_time);
 
 	return true;
 }
+
+bool benchmark_churn(int layers, unsigned int nodes, unsigned int operations, unsigned int flags){
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_custom_skip_list(layers, flags, NULL);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of nodes with even keys:
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_insert_node(skp, 2 * j, NULL)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+
+	//Every operation removes one existing node and inserts a new one at the end, the node count stays the same:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < operations; j++){
+		if(!sl_remove_node(skp, skp->zero_node->key)  ||  !sl_insert_node(skp, 2 * (nodes + j), NULL)){
+			printf("Error while removing/inserting a node\n");
+			return false;
+		}
+	}
+	double churn_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	printf("\toperations:\t\t\t%u\n", operations);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tmemory per node:\t\t%.2lf bytes\n", (double)sl_get_memory_usage(skp) / (double)nodes);
+	printf("\taverage time for remove+insert:\t%.3lf μs\n", churn_time / (double)operations);
+
+	sl_remove_skip_list(skp);
+
+	return true;
+}
+
+bool benchmark_finger(int layers, unsigned int nodes, int iterations, bool use_finger){
+	double summed_build_time = 0;
+	double summed_searching_time = 0;
+
+	for(int i = 0; i < iterations; i++){
+		//Create skiplist and finger:
+		sl_skip_list *skp = sl_create_skip_list(layers);
+		sl_set_seed(skp, BENCHMARK_SEED + i);
+		sl_finger *finger = sl_create_finger(skp);
+		if(finger == NULL){
+			printf("Error while creating the finger\n");
+			return false;
+		}
+
+		//Insertion of nodes with increasing keys:
+		clock_t start = clock();
+		for(unsigned int j = 0; j < nodes; j++){
+			if(!(use_finger ? sl_insert_from(finger, j, NULL) : sl_insert_node(skp, j, NULL))){
+				printf("Error while building up the whole skiplist\n");
+				return false;
+			}
+		}
+		summed_build_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		//Searching of clustered keys, every key is at most 16 keys away from the last one:
+		unsigned int key = nodes / 2;
+		start = clock();
+		for(unsigned int j = 0; j < nodes; j++){
+			key = (key + (unsigned int)rand() % 33 + nodes - 16) % nodes;
+			if((use_finger ? sl_get_node_from(finger, key) : sl_get_node(skp, key)) == NULL){
+				printf("Error while searching a node\n");
+				return false;
+			}
+		}
+		summed_searching_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		sl_remove_finger(finger);
+		sl_remove_skip_list(skp);
+	}
+
+	printf("\titerations:\t\t\t%d\n", iterations);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\taverage time per insertion:\t%.3lf μs\n", summed_build_time / (double)iterations / (double)nodes);
+	printf("\taverage time per search:\t%.3lf μs\n", summed_searching_time / (double)iterations / (double)nodes);
+
+	return true;
+}
+
+bool benchmark_batch(int layers, unsigned int nodes, unsigned int batch_size, int iterations, bool use_batch){
+	double summed_insertion_time = 0;
+	double summed_searching_time = 0;
+	double summed_removing_time = 0;
+
+	unsigned int *keys = malloc(sizeof(unsigned int) * (nodes > batch_size ? nodes : batch_size));
+	sl_node **found_nodes = malloc(sizeof(sl_node*) * batch_size);
+	if(keys == NULL  ||  found_nodes == NULL){
+		printf("Error while allocating the batch\n");
+		return false;
+	}
+
+	//Create skiplist with even keys:
+	sl_skip_list *skp = sl_create_skip_list(layers);
+	sl_set_seed(skp, BENCHMARK_SEED);
+	for(unsigned int j = 0; j < nodes; j++)
+		keys[j] = 2 * j;
+	if(!sl_bulk_load(skp, keys, NULL, nodes)){
+		printf("Error while loading the whole skiplist\n");
+		return false;
+	}
+
+	for(int i = 0; i < iterations; i++){
+		//Sorted batch of odd keys with random gaps:
+		unsigned int key = 1 + 2 * ((unsigned int)rand() % (nodes / batch_size));
+		for(unsigned int j = 0; j < batch_size; j++){
+			keys[j] = key;
+			key += 2 * (1 + (unsigned int)rand() % (2 * nodes / batch_size));
+		}
+
+		//Benchmarking of the insertions:
+		clock_t start = clock();
+		if(use_batch){
+			sl_insert_node_batch(skp, keys, NULL, batch_size, NULL);
+		}
+		else{
+			for(unsigned int j = 0; j < batch_size; j++)
+				sl_insert_node(skp, keys[j], NULL);
+		}
+		summed_insertion_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		//Benchmarking of the searches:
+		start = clock();
+		if(use_batch){
+			sl_get_node_batch(skp, keys, batch_size, found_nodes);
+		}
+		else{
+			for(unsigned int j = 0; j < batch_size; j++)
+				found_nodes[j] = sl_get_node(skp, keys[j]);
+		}
+		summed_searching_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		//Check if insertion and search were successfull:
+		for(unsigned int j = 0; j < batch_size; j++){
+			if(found_nodes[j] == NULL  ||  found_nodes[j]->key != keys[j]){
+				printf("Error while inserting/searching the batch\n");
+				return false;
+			}
+		}
+
+		//Benchmarking of the removes:
+		start = clock();
+		if(use_batch){
+			sl_remove_node_batch(skp, keys, batch_size, NULL);
+		}
+		else{
+			for(unsigned int j = 0; j < batch_size; j++)
+				sl_remove_node(skp, keys[j]);
+		}
+		summed_removing_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+	}
+
+	sl_remove_skip_list(skp);
+	free(keys);
+	free(found_nodes);
+
+	double keys_per_iteration = (double)iterations * (double)batch_size;
+
+	printf("\titerations:\t\t\t%d\n", iterations);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tbatch size:\t\t\t%u\n", batch_size);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\taverage time per insertion:\t%.3lf μs\n", summed_insertion_time / keys_per_iteration);
+	printf("\taverage time per search:\t%.3lf μs\n", summed_searching_time / keys_per_iteration);
+	printf("\taverage time per remove:\t%.3lf μs\n", summed_removing_time / keys_per_iteration);
+
+	return true;
+}
+
+bool benchmark_rank_select(int layers, unsigned int nodes, unsigned int operations, unsigned int flags){
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_custom_skip_list(layers, flags, NULL);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of nodes with even keys:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_insert_node(skp, 2 * j, NULL)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double build_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Benchmarking of rank, select and count:
+	double summed_rank_time = 0;
+	double summed_select_time = 0;
+	double summed_count_time = 0;
+
+	for(unsigned int j = 0; j < operations; j++){
+		unsigned int index = (unsigned int)rand() % nodes;
+
+		start = clock();
+		unsigned int rank = sl_rank(skp, 2 * index);
+		summed_rank_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		start = clock();
+		sl_node *node = sl_select(skp, index);
+		summed_select_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		start = clock();
+		unsigned int count = sl_count_range(skp, 2 * index, 2 * index + 200);
+		summed_count_time += (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+		//Check if rank, select and count were successfull:
+		unsigned int expected_count = nodes - index < 101 ? nodes - index : 101;
+		if(rank != index  ||  node == NULL  ||  node->key != 2 * index  ||  count != expected_count){
+			printf("Error while ranking/selecting/counting a node\n");
+			return false;
+		}
+	}
+
+	printf("\toperations:\t\t\t%u\n", operations);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tmemory per node:\t\t%.2lf bytes\n", (double)sl_get_memory_usage(skp) / (double)nodes);
+	printf("\n");
+	printf("\taverage time per insertion:\t%.3lf μs\n", build_time / (double)nodes);
+	printf("\taverage time for rank:\t\t%.3lf μs\n", summed_rank_time / (double)operations);
+	printf("\taverage time for select:\t%.3lf μs\n", summed_select_time / (double)operations);
+	printf("\taverage time for count:\t\t%.3lf μs\n", summed_count_time / (double)operations);
+
+	sl_remove_skip_list(skp);
+
+	return true;
+}
+
+//Shared state of the threads of benchmark_concurrent():
+typedef struct{
+	int mode;
+	sl_skip_list* skiplist;
+	pthread_mutex_t* mutex;
+	sl_concurrent_skip_list* concurrent_skiplist;
+	sl_sharded_skip_list* sharded_skiplist;
+	unsigned int key_range;
+	unsigned int operations;
+	unsigned int seed;
+	bool successfull;
+}concurrent_worker;
+
+void* run_concurrent_worker(void* argument){
+	concurrent_worker* worker = argument;
+
+	for(unsigned int j = 0; j < worker->operations; j++){
+		unsigned int key = (unsigned int)rand_r(&worker->seed) % worker->key_range;
+		unsigned int operation = (unsigned int)rand_r(&worker->seed) % 100;
+		bool is_insertion = operation < CONCURRENT_INSERT_PERCENT;
+		bool is_removal = !is_insertion  &&  operation < CONCURRENT_INSERT_PERCENT + CONCURRENT_REMOVE_PERCENT;
+		bool found = true;
+
+		switch(worker->mode){
+			case CONCURRENT_LOCK_FREE:
+				if(is_insertion)
+					found = sl_concurrent_insert_node(worker->concurrent_skiplist, key, NULL);
+				else if(is_removal)
+					sl_concurrent_remove_node(worker->concurrent_skiplist, key);
+				else
+					sl_concurrent_get_data(worker->concurrent_skiplist, key, NULL);
+				break;
+
+			case CONCURRENT_SHARDED:
+				if(is_insertion)
+					found = sl_sharded_insert_node(worker->sharded_skiplist, key, NULL);
+				else if(is_removal)
+					sl_sharded_remove_node(worker->sharded_skiplist, key);
+				else
+					sl_sharded_get_data(worker->sharded_skiplist, key, NULL);
+				break;
+
+			default:
+				pthread_mutex_lock(worker->mutex);
+				if(is_insertion)
+					found = sl_insert_node(worker->skiplist, key, NULL);
+				else if(is_removal)
+					sl_remove_node(worker->skiplist, key);
+				else
+					sl_get_node(worker->skiplist, key);
+				pthread_mutex_unlock(worker->mutex);
+				break;
+		}
+
+		//Check if the insertion was successfull:
+		if(!found){
+			worker->successfull = false;
+			return NULL;
+		}
+	}
+	worker->successfull = true;
+	return NULL;
+}
+
+bool benchmark_concurrent(int layers, unsigned int nodes, unsigned int operations, unsigned int threads, int mode){
+
+	//Create skiplist:
+	sl_skip_list *skp = NULL;
+	sl_concurrent_skip_list *concurrent_skp = NULL;
+	sl_sharded_skip_list *sharded_skp = NULL;
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	bool created;
+	switch(mode){
+		case CONCURRENT_LOCK_FREE:
+			created = (concurrent_skp = sl_create_concurrent_skip_list(layers)) != NULL;
+			break;
+		case CONCURRENT_SHARDED:
+			created = (sharded_skp = sl_create_sharded_skip_list(layers, CONCURRENT_SHARDS, 0)) != NULL;
+			break;
+		default:
+			created = (skp = sl_create_skip_list(layers)) != NULL;
+			if(created)
+				sl_set_seed(skp, BENCHMARK_SEED);
+			break;
+	}
+	if(!created){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+
+	//Insertion of nodes with even keys, half of the key range is used:
+	for(unsigned int j = 0; j < nodes; j++){
+		bool inserted;
+		switch(mode){
+			case CONCURRENT_LOCK_FREE:
+				inserted = sl_concurrent_insert_node(concurrent_skp, 2 * j, NULL);
+				break;
+			case CONCURRENT_SHARDED:
+				inserted = sl_sharded_insert_node(sharded_skp, 2 * j, NULL);
+				break;
+			default:
+				inserted = sl_insert_node(skp, 2 * j, NULL);
+				break;
+		}
+		if(!inserted){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+
+	//Every thread does the same amount of operations:
+	concurrent_worker workers[threads];
+	pthread_t thread_ids[threads];
+	for(unsigned int t = 0; t < threads; t++){
+		workers[t].mode = mode;
+		workers[t].skiplist = skp;
+		workers[t].mutex = &mutex;
+		workers[t].concurrent_skiplist = concurrent_skp;
+		workers[t].sharded_skiplist = sharded_skp;
+		workers[t].key_range = 2 * nodes;
+		workers[t].operations = operations / threads;
+		workers[t].seed = BENCHMARK_SEED + t;
+	}
+
+	//Wall clock time, clock() would add up the time of all threads:
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int t = 0; t < threads; t++){
+		if(pthread_create(&thread_ids[t], NULL, run_concurrent_worker, &workers[t]) != 0){
+			printf("Error while starting a thread\n");
+			return false;
+		}
+	}
+	bool successfull = true;
+	for(unsigned int t = 0; t < threads; t++){
+		pthread_join(thread_ids[t], NULL);
+		successfull = successfull  &&  workers[t].successfull;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double time = (double)(end.tv_sec - start.tv_sec) * 1000000 + (double)(end.tv_nsec - start.tv_nsec) / 1000;
+
+	if(!successfull){
+		printf("Error while inserting a node\n");
+		return false;
+	}
+
+	unsigned int node_count;
+	switch(mode){
+		case CONCURRENT_LOCK_FREE:
+			node_count = sl_concurrent_get_node_count(concurrent_skp);
+			break;
+		case CONCURRENT_SHARDED:
+			node_count = sl_sharded_get_node_count(sharded_skp);
+			break;
+		default:
+			node_count = skp->node_count_in_layer[0];
+			break;
+	}
+
+	unsigned int executed_operations = threads * (operations / threads);
+	printf("\toperations:\t\t\t%u\n", executed_operations);
+	printf("\tthreads:\t\t\t%u\n", threads);
+	printf("\tnodes at start:\t\t\t%u\n", nodes);
+	printf("\tnodes at end:\t\t\t%u\n", node_count);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\ttotal time:\t\t\t%.0lf μs\n", time);
+	printf("\tthroughput:\t\t\t%.3lf million operations/s\n", (double)executed_operations / time);
+
+	switch(mode){
+		case CONCURRENT_LOCK_FREE:
+			sl_remove_concurrent_skip_list(concurrent_skp);
+			break;
+		case CONCURRENT_SHARDED:
+			sl_remove_sharded_skip_list(sharded_skp);
+			break;
+		default:
+			sl_remove_skip_list(skp);
+			break;
+	}
+
+	return true;
+}
+
+//Shared state of the threads of benchmark_readers():
+typedef struct{
+	sl_skip_list* skiplist;
+	pthread_rwlock_t* lock;
+	sl_swmr_skip_list* swmr_skiplist;
+	unsigned int key_range;
+	unsigned int lookups;
+	unsigned int seed;
+	atomic_bool* is_stopped;
+	//found keys of a reader, operations of the writer
+	unsigned int count;
+}reader_worker;
+
+void* run_reader_worker(void* argument){
+	reader_worker* worker = argument;
+
+	for(unsigned int j = 0; j < worker->lookups; j++){
+		unsigned int key = (unsigned int)rand_r(&worker->seed) % worker->key_range;
+		if(worker->swmr_skiplist != NULL){
+			worker->count += sl_swmr_get_data(worker->swmr_skiplist, key, NULL);
+		}
+		else{
+			pthread_rwlock_rdlock(worker->lock);
+			worker->count += sl_get_node(worker->skiplist, key) != NULL;
+			pthread_rwlock_unlock(worker->lock);
+		}
+	}
+	return NULL;
+}
+
+void* run_writer_worker(void* argument){
+	reader_worker* worker = argument;
+
+	//Insert and remove odd keys until all readers are done:
+	while(!atomic_load(worker->is_stopped)){
+		unsigned int key = 2 * ((unsigned int)rand_r(&worker->seed) % (worker->key_range / 2)) + 1;
+		bool is_insertion = rand_r(&worker->seed) % 2 == 0;
+		if(worker->swmr_skiplist != NULL){
+			if(is_insertion)
+				sl_swmr_insert_node(worker->swmr_skiplist, key, NULL);
+			else
+				sl_swmr_remove_node(worker->swmr_skiplist, key);
+		}
+		else{
+			pthread_rwlock_wrlock(worker->lock);
+			if(is_insertion)
+				sl_insert_node(worker->skiplist, key, NULL);
+			else
+				sl_remove_node(worker->skiplist, key);
+			pthread_rwlock_unlock(worker->lock);
+		}
+		worker->count++;
+	}
+	return NULL;
+}
+
+bool benchmark_readers(int layers, unsigned int nodes, unsigned int lookups, unsigned int readers, bool use_swmr){
+
+	//Create skiplist:
+	sl_skip_list *skp = NULL;
+	sl_swmr_skip_list *swmr_skp = NULL;
+	pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+	if(use_swmr)
+		swmr_skp = sl_create_swmr_skip_list(layers);
+	else
+		skp = sl_create_skip_list(layers);
+	if(skp == NULL  &&  swmr_skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	if(skp != NULL)
+		sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of nodes with even keys, the writer changes only odd keys:
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!(use_swmr ? sl_swmr_insert_node(swmr_skp, 2 * j, NULL) : sl_insert_node(skp, 2 * j, NULL))){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+
+	//Every reader does the same amount of lookups, the writer runs until they are done:
+	atomic_bool is_stopped = false;
+	reader_worker workers[readers + 1];
+	pthread_t thread_ids[readers + 1];
+	for(unsigned int t = 0; t <= readers; t++){
+		workers[t].skiplist = skp;
+		workers[t].lock = &lock;
+		workers[t].swmr_skiplist = swmr_skp;
+		workers[t].key_range = 2 * nodes;
+		workers[t].lookups = lookups / readers;
+		workers[t].seed = BENCHMARK_SEED + t;
+		workers[t].is_stopped = &is_stopped;
+		workers[t].count = 0;
+	}
+
+	//Wall clock time, clock() would add up the time of all threads:
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int t = 0; t <= readers; t++){
+		if(pthread_create(&thread_ids[t], NULL, t == readers ? run_writer_worker : run_reader_worker, &workers[t]) != 0){
+			printf("Error while starting a thread\n");
+			return false;
+		}
+	}
+	unsigned int found_count = 0;
+	for(unsigned int t = 0; t < readers; t++){
+		pthread_join(thread_ids[t], NULL);
+		found_count += workers[t].count;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	atomic_store(&is_stopped, true);
+	pthread_join(thread_ids[readers], NULL);
+	double time = (double)(end.tv_sec - start.tv_sec) * 1000000 + (double)(end.tv_nsec - start.tv_nsec) / 1000;
+
+	//Check if all even keys were found, odd keys might be found as well:
+	unsigned int executed_lookups = readers * (lookups / readers);
+	if(found_count < executed_lookups / 2 - executed_lookups / 100){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	printf("\tlookups:\t\t\t%u\n", executed_lookups);
+	printf("\treaders:\t\t\t%u\n", readers);
+	printf("\twriter operations:\t\t%u\n", workers[readers].count);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\ttotal time:\t\t\t%.0lf μs\n", time);
+	printf("\tlookup throughput:\t\t%.3lf million lookups/s\n", (double)executed_lookups / time);
+
+	if(use_swmr)
+		sl_remove_swmr_skip_list(swmr_skp);
+	else
+		sl_remove_skip_list(skp);
+
+	return true;
+}
+
+//Shared state of the writer of benchmark_snapshot():
+typedef struct{
+	sl_skip_list* skiplist;
+	pthread_mutex_t* mutex;
+	sl_mvcc_skip_list* mvcc_skiplist;
+	unsigned int key_range;
+	unsigned int seed;
+	atomic_bool* is_stopped;
+	unsigned int operation_count;
+}snapshot_writer;
+
+void* run_snapshot_writer(void* argument){
+	snapshot_writer* writer = argument;
+
+	//Insert and remove odd keys until all scans are done:
+	while(!atomic_load(writer->is_stopped)){
+		unsigned int key = 2 * ((unsigned int)rand_r(&writer->seed) % (writer->key_range / 2)) + 1;
+		bool is_insertion = rand_r(&writer->seed) % 2 == 0;
+		if(writer->mvcc_skiplist != NULL){
+			if(is_insertion)
+				sl_mvcc_insert_node(writer->mvcc_skiplist, key, NULL);
+			else
+				sl_mvcc_remove_node(writer->mvcc_skiplist, key);
+		}
+		else{
+			pthread_mutex_lock(writer->mutex);
+			if(is_insertion)
+				sl_insert_node(writer->skiplist, key, NULL);
+			else
+				sl_remove_node(writer->skiplist, key);
+			pthread_mutex_unlock(writer->mutex);
+		}
+		writer->operation_count++;
+	}
+	return NULL;
+}
+
+bool count_even_node(sl_node* node, void* context){
+	*(unsigned int*)context += node->key % 2 == 0;
+	return true;
+}
+
+bool count_even_key(unsigned int key, void* data, void* context){
+	(void)data;
+	*(unsigned int*)context += key % 2 == 0;
+	return true;
+}
+
+bool benchmark_snapshot(int layers, unsigned int nodes, unsigned int scans, bool use_snapshot){
+
+	//Create skiplist:
+	sl_skip_list *skp = NULL;
+	sl_mvcc_skip_list *mvcc_skp = NULL;
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	if(use_snapshot)
+		mvcc_skp = sl_create_mvcc_skip_list(layers);
+	else
+		skp = sl_create_skip_list(layers);
+	if(skp == NULL  &&  mvcc_skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	if(skp != NULL)
+		sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of nodes with even keys, the writer changes only odd keys:
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!(use_snapshot ? sl_mvcc_insert_node(mvcc_skp, 2 * j, NULL) : sl_insert_node(skp, 2 * j, NULL))){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+
+	atomic_bool is_stopped = false;
+	snapshot_writer writer = { .skiplist = skp, .mutex = &mutex, .mvcc_skiplist = mvcc_skp, .key_range = 2 * nodes,
+		.seed = BENCHMARK_SEED, .is_stopped = &is_stopped, .operation_count = 0 };
+	pthread_t writer_id;
+	if(pthread_create(&writer_id, NULL, run_snapshot_writer, &writer) != 0){
+		printf("Error while starting a thread\n");
+		return false;
+	}
+
+	//Wall clock time, clock() would add up the time of both threads:
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int j = 0; j < scans; j++){
+		unsigned int even_count = 0;
+		if(use_snapshot){
+			sl_mvcc_snapshot* snapshot = sl_snapshot(mvcc_skp);
+			if(snapshot == NULL){
+				printf("Error while taking a snapshot\n");
+				return false;
+			}
+			sl_snapshot_scan_range(snapshot, 0, UINT_MAX, count_even_key, &even_count);
+			sl_release_snapshot(snapshot);
+		}
+		else{
+			pthread_mutex_lock(&mutex);
+			sl_scan_range(skp, 0, UINT_MAX, count_even_node, &even_count);
+			pthread_mutex_unlock(&mutex);
+		}
+
+		//Check if the scan saw all even keys:
+		if(even_count != nodes){
+			printf("Error while scanning the skiplist\n");
+			return false;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	atomic_store(&is_stopped, true);
+	pthread_join(writer_id, NULL);
+	double time = (double)(end.tv_sec - start.tv_sec) * 1000000 + (double)(end.tv_nsec - start.tv_nsec) / 1000;
+
+	printf("\tscans:\t\t\t\t%u\n", scans);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\taverage time per scan:\t\t%.0lf μs\n", time / (double)scans);
+	printf("\twriter operations meanwhile:\t%u\n", writer.operation_count);
+
+	if(use_snapshot)
+		sl_remove_mvcc_skip_list(mvcc_skp);
+	else
+		sl_remove_skip_list(skp);
+
+	return true;
+}
+
+int compare_u64(const void* key_a, const void* key_b){
+	uint64_t a = *(const uint64_t*)key_a;
+	uint64_t b = *(const uint64_t*)key_b;
+	return (a > b) - (a < b);
+}
+
+bool benchmark_typed(int layers, unsigned int nodes, unsigned int lookups, int key_type){
+
+	//Keys in random order, the byte keys are big endian so memcmp() sorts them like the numbers:
+	uint64_t *keys = malloc(nodes * sizeof(uint64_t));
+	unsigned char *byte_keys = malloc((size_t)nodes * TYPED_BYTES_LENGTH);
+	if(keys == NULL  ||  byte_keys == NULL){
+		printf("Error while allocating the keys\n");
+		return false;
+	}
+	for(unsigned int j = 0; j < nodes; j++){
+		keys[j] = key_type == TYPED_SL_NODE  ||  key_type == TYPED_U32 ? (uint32_t)(j * 2654435761u) : j * 11400714819323198485ull;
+		memset(byte_keys + (size_t)j * TYPED_BYTES_LENGTH, 0, TYPED_BYTES_LENGTH);
+		for(int b = 0; b < 8; b++)
+			byte_keys[(size_t)j * TYPED_BYTES_LENGTH + TYPED_BYTES_LENGTH - 1 - b] = (unsigned char)(keys[j] >> (8 * b));
+	}
+
+	//Create skiplist:
+	sl_skip_list *skp = NULL;
+	sl_u32_skip_list *u32_skp = NULL;
+	sl_u64_skip_list *u64_skp = NULL;
+	sl_generic_skip_list *generic_skp = NULL;
+	sl_bytes_skip_list *bytes_skp = NULL;
+	switch(key_type){
+		case TYPED_SL_NODE:		skp = sl_create_skip_list(layers);											break;
+		case TYPED_U32:			u32_skp = sl_create_u32_skip_list(layers);									break;
+		case TYPED_U64:			u64_skp = sl_create_u64_skip_list(layers);									break;
+		case TYPED_COMPARATOR:	generic_skp = sl_create_comparator_skip_list(layers, sizeof(uint64_t), compare_u64);	break;
+		default:				bytes_skp = sl_create_bytes_skip_list(layers);								break;
+	}
+	if(skp == NULL  &&  u32_skp == NULL  &&  u64_skp == NULL  &&  generic_skp == NULL  &&  bytes_skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+
+	//Same heights in every run:
+	switch(key_type){
+		case TYPED_SL_NODE:		sl_set_seed(skp, BENCHMARK_SEED);					break;
+		case TYPED_U32:			sl_u32_set_seed(u32_skp, BENCHMARK_SEED);			break;
+		case TYPED_U64:			sl_u64_set_seed(u64_skp, BENCHMARK_SEED);			break;
+		case TYPED_COMPARATOR:	sl_generic_set_seed(generic_skp, BENCHMARK_SEED);	break;
+		default:				sl_bytes_set_seed(bytes_skp, BENCHMARK_SEED);		break;
+	}
+
+	//Insertion of all keys:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		sl_bytes byte_key = { .bytes = byte_keys + (size_t)j * TYPED_BYTES_LENGTH, .length = TYPED_BYTES_LENGTH };
+		bool inserted;
+		switch(key_type){
+			case TYPED_SL_NODE:		inserted = sl_insert_node(skp, (unsigned int)keys[j], NULL);	break;
+			case TYPED_U32:			inserted = sl_u32_insert_node(u32_skp, (uint32_t)keys[j], NULL);	break;
+			case TYPED_U64:			inserted = sl_u64_insert_node(u64_skp, keys[j], NULL);			break;
+			case TYPED_COMPARATOR:	inserted = sl_generic_insert_node(generic_skp, &keys[j], NULL);	break;
+			default:				inserted = sl_bytes_insert_node(bytes_skp, byte_key, NULL);		break;
+		}
+		if(!inserted){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double insertion_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Search random keys:
+	srand(BENCHMARK_SEED);
+	unsigned int found_count = 0;
+	start = clock();
+	for(unsigned int j = 0; j < lookups; j++){
+		unsigned int index = (unsigned int)rand() % nodes;
+		sl_bytes byte_key = { .bytes = byte_keys + (size_t)index * TYPED_BYTES_LENGTH, .length = TYPED_BYTES_LENGTH };
+		switch(key_type){
+			case TYPED_SL_NODE:		found_count += sl_get_node(skp, (unsigned int)keys[index]) != NULL;		break;
+			case TYPED_U32:			found_count += sl_u32_get_node(u32_skp, (uint32_t)keys[index]) != NULL;	break;
+			case TYPED_U64:			found_count += sl_u64_get_node(u64_skp, keys[index]) != NULL;			break;
+			case TYPED_COMPARATOR:	found_count += sl_generic_get_node(generic_skp, &keys[index]) != NULL;	break;
+			default:				found_count += sl_bytes_get_node(bytes_skp, byte_key) != NULL;			break;
+		}
+	}
+	double searching_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Check if all keys were found:
+	if(found_count != lookups){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\taverage time per insertion:\t%.3lf μs\n", insertion_time / (double)nodes);
+	printf("\taverage time per search:\t%.3lf μs\n", searching_time / (double)lookups);
+
+	switch(key_type){
+		case TYPED_SL_NODE:		sl_remove_skip_list(skp);					break;
+		case TYPED_U32:			sl_remove_u32_skip_list(u32_skp);			break;
+		case TYPED_U64:			sl_remove_u64_skip_list(u64_skp);			break;
+		case TYPED_COMPARATOR:	sl_remove_generic_skip_list(generic_skp);	break;
+		default:				sl_remove_bytes_skip_list(bytes_skp);		break;
+	}
+	free(keys);
+	free(byte_keys);
+
+	return true;
+}
+
+bool benchmark_blocked(int layers, unsigned int nodes, unsigned int lookups, bool use_blocks){
+
+	//Create skiplist:
+	sl_skip_list *skp = NULL;
+	sl_blocked_skip_list *blocked_skp = NULL;
+	if(use_blocks)
+		blocked_skp = sl_create_blocked_skip_list(layers);
+	else
+		skp = sl_create_skip_list(layers);
+	if(skp == NULL  &&  blocked_skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	if(skp != NULL)
+		sl_set_seed(skp, BENCHMARK_SEED);
+	else
+		sl_blocked_set_seed(blocked_skp, BENCHMARK_SEED);
+
+	//Insertion of keys in random order:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		unsigned int key = j * 2654435761u;
+		if(!(use_blocks ? sl_blocked_insert_node(blocked_skp, key, NULL) : sl_insert_node(skp, key, NULL))){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double insertion_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Search random keys and count the cache misses:
+	srand(BENCHMARK_SEED);
+	unsigned int found_count = 0;
+	int counter = start_cache_miss_counter();
+	start = clock();
+	for(unsigned int j = 0; j < lookups; j++){
+		unsigned int key = ((unsigned int)rand() % nodes) * 2654435761u;
+		found_count += use_blocks ? sl_blocked_get_data(blocked_skp, key, NULL) : sl_get_node(skp, key) != NULL;
+	}
+	double searching_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+	long long cache_misses = stop_cache_miss_counter(counter);
+
+	//Check if all keys were found:
+	if(found_count != lookups){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	size_t memory_usage = use_blocks ? sl_blocked_get_memory_usage(blocked_skp) : sl_get_memory_usage(skp);
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tmemory per node:\t\t%.2lf bytes\n", (double)memory_usage / (double)nodes);
+	printf("\n");
+	printf("\taverage time per insertion:\t%.3lf μs\n", insertion_time / (double)nodes);
+	printf("\taverage time per search:\t%.3lf μs\n", searching_time / (double)lookups);
+	print_cache_misses(cache_misses, lookups);
+
+	if(use_blocks)
+		sl_remove_blocked_skip_list(blocked_skp);
+	else
+		sl_remove_skip_list(skp);
+
+	return true;
+}
+
+bool benchmark_successor_keys(int layers, unsigned int nodes, unsigned int lookups, unsigned int flags){
+
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_custom_skip_list(layers, flags, NULL);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of keys in random order:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_insert_node(skp, j * 2654435761u, NULL)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double insertion_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Search random keys and count the cache misses:
+	srand(BENCHMARK_SEED);
+	unsigned int found_count = 0;
+	int counter = start_cache_miss_counter();
+	start = clock();
+	for(unsigned int j = 0; j < lookups; j++){
+		unsigned int key = ((unsigned int)rand() % nodes) * 2654435761u;
+		found_count += sl_get_node(skp, key) != NULL;
+	}
+	double searching_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+	long long cache_misses = stop_cache_miss_counter(counter);
+
+	//Check if all keys were found:
+	if(found_count != lookups){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tmemory per node:\t\t%.2lf bytes\n", (double)sl_get_memory_usage(skp) / (double)nodes);
+	printf("\n");
+	printf("\taverage time per insertion:\t%.3lf μs\n", insertion_time / (double)nodes);
+	printf("\taverage time per search:\t%.3lf μs\n", searching_time / (double)lookups);
+	print_cache_misses(cache_misses, lookups);
+
+	sl_remove_skip_list(skp);
+
+	return true;
+}
+
+bool benchmark_get_many(int layers, unsigned int nodes, unsigned int lookups, unsigned int flags){
+
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_custom_skip_list(layers, flags, NULL);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of keys in random order, the nodes get scattered over the heap:
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_insert_node(skp, j * 2654435761u, NULL)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+
+	//Random keys in random order:
+	unsigned int* keys = malloc(sizeof(unsigned int) * lookups);
+	sl_node** found_nodes = malloc(sizeof(sl_node*) * lookups);
+	if(keys == NULL  ||  found_nodes == NULL){
+		printf("Error while allocating the keys\n");
+		return false;
+	}
+	srand(BENCHMARK_SEED);
+	for(unsigned int j = 0; j < lookups; j++)
+		keys[j] = ((unsigned int)rand() % nodes) * 2654435761u;
+
+	//Search every key on its own:
+	unsigned int found_count = 0;
+	clock_t start = clock();
+	for(unsigned int j = 0; j < lookups; j++){
+		found_nodes[j] = sl_get_node(skp, keys[j]);
+		found_count += found_nodes[j] != NULL;
+	}
+	double searching_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Search all keys interleaved:
+	start = clock();
+	unsigned int found_many_count = sl_get_many(skp, keys, lookups, found_nodes);
+	double searching_many_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Check if all keys were found:
+	if(found_count != lookups  ||  found_many_count != lookups){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\taverage time per sl_get_node():\t%.3lf μs\n", searching_time / (double)lookups);
+	printf("\taverage time per key of sl_get_many():\t%.3lf μs\n", searching_many_time / (double)lookups);
+
+	free(keys);
+	free(found_nodes);
+	sl_remove_skip_list(skp);
+
+	return true;
+}
+
+bool benchmark_upsert(int layers, unsigned int nodes, unsigned int operations, bool use_upsert){
+
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_skip_list(layers);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Every second write is a new key, the others update a random existing key:
+	srand(BENCHMARK_SEED);
+	unsigned int inserted_count = 0;
+	clock_t start = clock();
+	for(unsigned int j = 0; j < operations; j++){
+		unsigned int index = (j % 2 == 0  ||  inserted_count == 0) ? inserted_count++ : (unsigned int)rand() % inserted_count;
+		unsigned int key = (index % nodes) * 2654435761u;
+		bool result = use_upsert ? sl_upsert(skp, key, NULL) != NULL : sl_insert_node(skp, key, NULL);
+		if(!result){
+			printf("Error while writing a node\n");
+			return false;
+		}
+	}
+	double writing_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	printf("\toperations:\t\t\t%u\n", operations);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\n");
+	printf("\taverage time per write:\t\t%.3lf μs\n", writing_time / (double)operations);
+
+	sl_remove_skip_list(skp);
+
+	return true;
+}
+
+size_t serialize_value(void* data, void* buffer, size_t size, void* context){
+	//The data pointer itself is the value:
+	if(size >= sizeof(data))
+		memcpy(buffer, &data, sizeof(data));
+	return sizeof(data);
+}
+
+bool deserialize_value(const void* buffer, size_t size, void** data, void* context){
+	if(size != sizeof(*data))
+		return false;
+	memcpy(data, buffer, sizeof(*data));
+	return true;
+}
+
+bool benchmark_save_load(int layers, unsigned int nodes){
+
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_skip_list(layers);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+
+	//Insertion of keys in random order, every node gets its position as value:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_insert_node(skp, j * 2654435761u, (void*)(uintptr_t)j)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double insertion_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	FILE* file = tmpfile();
+	if(file == NULL){
+		printf("Error while creating the file\n");
+		return false;
+	}
+	int fd = fileno(file);
+
+	start = clock();
+	bool is_saved = sl_save(skp, fd, serialize_value, NULL);
+	double saving_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+	off_t file_size = lseek(fd, 0, SEEK_CUR);
+
+	lseek(fd, 0, SEEK_SET);
+	start = clock();
+	sl_skip_list *loaded_skp = sl_load(fd, deserialize_value, NULL);
+	double loading_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+	fclose(file);
+
+	//Check if the loaded skip list holds the same nodes:
+	if(!is_saved  ||  loaded_skp == NULL  ||  loaded_skp->node_count_in_layer[0] != nodes  ||
+	   sl_get_node(loaded_skp, 7 * 2654435761u)->data != (void*)7){
+		printf("Error while saving or loading the skiplist\n");
+		return false;
+	}
+
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tfile size per node:\t\t%.2lf bytes\n", (double)file_size / (double)nodes);
+	printf("\n");
+	printf("\ttime of all insertions:\t\t%.3lf s\n", insertion_time / 1000000);
+	printf("\ttime of sl_save():\t\t%.3lf s\n", saving_time / 1000000);
+	printf("\ttime of sl_load():\t\t%.3lf s\n", loading_time / 1000000);
+
+	sl_remove_skip_list(skp);
+	sl_remove_skip_list(loaded_skp);
+
+	return true;
+}
+
+bool benchmark_mapped(int layers, unsigned int nodes, unsigned int lookups){
+	const char* path = "/tmp/skiplist_benchmark.map";
+
+	//Start with a new file:
+	unlink(path);
+	sl_mapped_skip_list *skp = sl_open_mapped_skip_list(path, layers);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+
+	//Insertion of keys in random order:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_mapped_insert_node(skp, j * 2654435761u, j)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double insertion_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+	if(!sl_close_mapped_skip_list(skp)){
+		printf("Error while closing the skiplist\n");
+		return false;
+	}
+
+	//Reopen it, nothing is loaded:
+	struct timespec open_start, open_end;
+	clock_gettime(CLOCK_MONOTONIC, &open_start);
+	skp = sl_open_mapped_skip_list(path, layers);
+	clock_gettime(CLOCK_MONOTONIC, &open_end);
+	if(skp == NULL  ||  sl_mapped_get_node_count(skp) != nodes){
+		printf("Error while reopening the skiplist\n");
+		return false;
+	}
+	double opening_time = (open_end.tv_sec - open_start.tv_sec) * 1000000.0 + (open_end.tv_nsec - open_start.tv_nsec) / 1000.0;
+
+	//Search random keys, the first searches read the pages of the file:
+	srand(BENCHMARK_SEED);
+	unsigned int found_count = 0;
+	start = clock();
+	for(unsigned int j = 0; j < lookups; j++){
+		unsigned int index = (unsigned int)rand() % nodes;
+		uint64_t value;
+		found_count += sl_mapped_get_value(skp, index * 2654435761u, &value)  &&  value == index;
+	}
+	double searching_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Check if all keys were found:
+	if(found_count != lookups){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tfile size per node:\t\t%.2lf bytes\n", (double)sl_mapped_get_file_size(skp) / (double)nodes);
+	printf("\n");
+	printf("\taverage time per insertion:\t%.3lf μs\n", insertion_time / (double)nodes);
+	printf("\ttime of reopening:\t\t%.3lf μs\n", opening_time);
+	printf("\taverage time per search:\t%.3lf μs\n", searching_time / (double)lookups);
+
+	sl_close_mapped_skip_list(skp);
+	unlink(path);
+
+	return true;
+}
+
+bool benchmark_memtable(int layers, unsigned int writes, unsigned int lookups, size_t flush_threshold){
+	//An own directory, runs that are already in it would be read too:
+	char directory[] = "/tmp/sl-memtable-XXXXXX";
+	if(mkdtemp(directory) == NULL){
+		printf("Error while creating the run directory\n");
+		return false;
+	}
+
+	//Create memtable:
+	sl_memtable *memtable = sl_create_memtable(directory, layers, flush_threshold);
+	if(memtable == NULL){
+		printf("Error while creating the memtable\n");
+		return false;
+	}
+
+	//Writes of random keys, every tenth one is a delete. The slowest write shows whether writes wait for flushes:
+	srand(BENCHMARK_SEED);
+	double longest_write_time = 0;
+	struct timespec start, end, write_start, write_end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int j = 0; j < writes; j++){
+		unsigned int key = (unsigned int)rand() % writes;
+		clock_gettime(CLOCK_MONOTONIC, &write_start);
+		bool result = j % 10 == 9 ? sl_memtable_delete(memtable, key) : sl_memtable_put(memtable, key, key);
+		clock_gettime(CLOCK_MONOTONIC, &write_end);
+		if(!result){
+			printf("Error while writing\n");
+			return false;
+		}
+		double write_time = (write_end.tv_sec - write_start.tv_sec) * 1000000.0 + (write_end.tv_nsec - write_start.tv_nsec) / 1000.0;
+		if(write_time > longest_write_time)
+			longest_write_time = write_time;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double writing_time = (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0;
+
+	if(!sl_memtable_flush(memtable)){
+		printf("Error while flushing\n");
+		return false;
+	}
+
+	//Lookups of random keys read the runs:
+	unsigned int found_count = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int j = 0; j < lookups; j++){
+		uint64_t value;
+		bool is_failed;
+		unsigned int key = (unsigned int)rand() % writes;
+		if(sl_memtable_get(memtable, key, &value, &is_failed)){
+			if(value != key){
+				printf("Error while searching nodes\n");
+				return false;
+			}
+			found_count++;
+		}
+		else if(is_failed){
+			printf("Error while reading a run\n");
+			return false;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double searching_time = (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0;
+
+	unsigned int run_count = sl_memtable_get_run_count(memtable);
+	printf("\twrites:\t\t\t\t%u\n", writes);
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\truns:\t\t\t\t%u\n", run_count);
+	printf("\tfound keys:\t\t\t%u\n", found_count);
+	printf("\n");
+	printf("\taverage time per write:\t\t%.3lf μs\n", writing_time / (double)writes);
+	printf("\tlongest write:\t\t\t%.3lf μs\n", longest_write_time);
+	printf("\taverage time per lookup:\t%.3lf μs\n", searching_time / (double)lookups);
+
+	//A second memtable on the same directory reads the same runs and writes its runs behind them:
+	sl_memtable *reopened = sl_create_memtable(directory, layers, flush_threshold);
+	if(reopened == NULL  ||  sl_memtable_get_run_count(reopened) != run_count){
+		printf("Error while reading the runs of an earlier memtable\n");
+		return false;
+	}
+	for(unsigned int j = 0; j < lookups; j++){
+		uint64_t value, reopened_value;
+		bool is_failed, is_reopened_failed;
+		unsigned int key = (unsigned int)rand() % writes;
+		bool is_found = sl_memtable_get(memtable, key, &value, &is_failed);
+		if(sl_memtable_get(reopened, key, &reopened_value, &is_reopened_failed) != is_found  ||  is_failed  ||  is_reopened_failed  ||
+				(is_found  &&  reopened_value != value)){
+			printf("Error while searching the runs of an earlier memtable\n");
+			return false;
+		}
+	}
+	if(!sl_memtable_put(reopened, 0, 0)  ||  !sl_memtable_flush(reopened)  ||  sl_memtable_get_run_count(reopened) != run_count + 1){
+		printf("Error while writing behind the runs of an earlier memtable\n");
+		return false;
+	}
+	run_count++;
+
+	sl_remove_memtable(reopened);
+	sl_remove_memtable(memtable);
+
+	//Remove the run files and the directory:
+	for(unsigned int j = 0; j < run_count; j++){
+		char path[64];
+		snprintf(path, sizeof(path), "%s/run-%06u.sl", directory, j);
+		unlink(path);
+	}
+	rmdir(directory);
+
+	return true;
+}
+
+bool benchmark_stats(int layers, unsigned int nodes, unsigned int lookups, sl_probability probability, unsigned int flags){
+
+	//Create skiplist:
+	sl_skip_list *skp = sl_create_custom_skip_list(layers, flags, NULL);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	sl_set_seed(skp, BENCHMARK_SEED);
+	sl_set_probability(skp, probability);
+
+	//Insertion of keys in random order:
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_insert_node(skp, j * 2654435761u, NULL)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+
+	//Only count the searches:
+	sl_reset_stats(skp);
+	srand(BENCHMARK_SEED);
+	unsigned int found_count = 0;
+	for(unsigned int j = 0; j < lookups; j++){
+		unsigned int key = ((unsigned int)rand() % nodes) * 2654435761u;
+		found_count += sl_get_node(skp, key) != NULL;
+	}
+
+	//Check if all keys were found:
+	if(found_count != lookups){
+		printf("Error while searching nodes\n");
+		return false;
+	}
+
+	sl_stats stats;
+	sl_get_stats(skp, &stats);
+
+	printf("\tlookups:\t\t\t%u\n", lookups);
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%u\n", stats.layer_count);
+	printf("\tunused layers:\t\t\t%u\n", stats.unused_layers);
+	printf("\tmemory per node:\t\t%.2lf bytes\n", (double)stats.allocated_bytes / (double)nodes);
+	printf("\n");
+
+	//Nodes per layer, the ratio of two layers should be close to p:
+	for(unsigned int j = 0; j < stats.layer_count - stats.unused_layers; j++)
+		printf("\tnodes in layer %u:\t\t%u\n", j, stats.node_count_in_layer[j]);
+	printf("\n");
+
+	if(!stats.is_counting){
+		printf("\tcounters:\t\t\tcompiled without SL_STATISTICS\n");
+		sl_remove_skip_list(skp);
+		return true;
+	}
+
+	//Median and longest search of the histogram:
+	unsigned long long summed_searches = 0;
+	int median_length = -1;
+	int maximum_length = 0;
+	for(int j = 0; j < SL_SEARCH_LENGTH_BUCKETS; j++){
+		summed_searches += stats.counters.search_lengths[j];
+		if(median_length == -1  &&  summed_searches * 2 >= stats.counters.searches)
+			median_length = j;
+		if(stats.counters.search_lengths[j] > 0)
+			maximum_length = j;
+	}
+
+	printf("\tsearches:\t\t\t%llu\n", stats.counters.searches);
+	printf("\tcomparisons per search:\t\t%.2lf\n", (double)stats.counters.comparisons / (double)stats.counters.searches);
+	printf("\tvisited nodes per search:\t%.2lf\n", (double)stats.counters.visited_nodes / (double)stats.counters.searches);
+	printf("\tmedian visited nodes:\t\t%d\n", median_length);
+	printf("\tmaximum visited nodes:\t\t%d%s\n", maximum_length, maximum_length == SL_SEARCH_LENGTH_BUCKETS - 1 ? " or more" : "");
+
+	sl_remove_skip_list(skp);
+	return true;
+}
+
+bool benchmark_skewed_shards(int layers, unsigned int nodes, unsigned int shards){
+
+	//Create skiplist:
+	sl_sharded_skip_list *skp = sl_create_sharded_skip_list(layers, shards, 0);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+
+	//Insertion of ascending keys, the first shard gets all of them until the boundaries move:
+	clock_t start = clock();
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_sharded_insert_node(skp, j, NULL)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	double insertion_time = (double)(clock() - start) / (CLOCKS_PER_SEC / 1000000);
+
+	//Check that no shard holds much more than the average, a rebalance happens above 1.5 times the average:
+	unsigned int largest_count = 0;
+	for(unsigned int j = 0; j < shards; j++){
+		unsigned int node_count = sl_sharded_get_shard_node_count(skp, j);
+		largest_count = node_count > largest_count ? node_count : largest_count;
+	}
+	if(sl_sharded_get_node_count(skp) != nodes  ||  (unsigned long long)largest_count * shards * 2 > 3ULL * nodes + 2048ULL * shards){
+		printf("Error while rebalancing the shards\n");
+		return false;
+	}
+
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tshards:\t\t\t\t%u\n", shards);
+	printf("\taverage time per insertion:\t%.3lf μs\n", insertion_time / (double)nodes);
+	printf("\n");
+	for(unsigned int j = 0; j < shards; j++)
+		printf("\tnodes in shard %u:\t\t%u\n", j, sl_sharded_get_shard_node_count(skp, j));
+
+	sl_remove_sharded_skip_list(skp);
+	return true;
+}
+
+bool benchmark_mapped_recovery(int layers, unsigned int nodes){
+	const char* path = "/tmp/skiplist_recovery.map";
+
+	//Checkpoint the keys 0 to nodes - 1:
+	unlink(path);
+	sl_mapped_skip_list *skp = sl_open_mapped_skip_list(path, layers);
+	if(skp == NULL){
+		printf("Error while creating the skiplist\n");
+		return false;
+	}
+	for(unsigned int j = 0; j < nodes; j++){
+		if(!sl_mapped_insert_node(skp, j, j)){
+			printf("Error while building up the whole skiplist\n");
+			return false;
+		}
+	}
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	bool is_written = sl_mapped_checkpoint(skp);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double checkpoint_time = (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0;
+	size_t file_size = sl_mapped_get_file_size(skp);
+	if(!is_written  ||  !sl_close_mapped_skip_list(skp)){
+		printf("Error while writing the checkpoint\n");
+		return false;
+	}
+
+	//A child changes every key and more without a checkpoint, then it crashes:
+	pid_t child = fork();
+	if(child == 0){
+		sl_mapped_skip_list* child_skp = sl_open_mapped_skip_list(path, layers);
+		for(unsigned int j = 0; child_skp != NULL  &&  j < nodes; j++){
+			sl_mapped_insert_node(child_skp, j, j + 1);
+			sl_mapped_insert_node(child_skp, nodes + j, j);
+			sl_mapped_remove_node(child_skp, j / 2);
+		}
+		_exit(0);
+	}
+	if(child < 0  ||  waitpid(child, NULL, 0) != child){
+		printf("Error while crashing a process\n");
+		return false;
+	}
+	skp = sl_open_mapped_skip_list(path, layers);
+	if(!has_mapped_keys(skp, nodes)){
+		printf("Error while reopening the skiplist after a crash\n");
+		return false;
+	}
+	sl_close_mapped_skip_list(skp);
+
+	//A torn redo log behind the file, its trailer doesn't match:
+	int fd = open(path, O_WRONLY | O_APPEND);
+	unsigned char torn_log[8192];
+	memset(torn_log, 0xAB, sizeof(torn_log));
+	memcpy(torn_log + sizeof(torn_log) - 32, "SLLOG001", 8);
+	bool is_torn = fd >= 0  &&  write(fd, torn_log, sizeof(torn_log)) == sizeof(torn_log);
+	if(fd >= 0)
+		close(fd);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	skp = is_torn ? sl_open_mapped_skip_list(path, layers) : NULL;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double recovery_time = (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0;
+	if(!has_mapped_keys(skp, nodes)  ||  sl_mapped_get_file_size(skp) != file_size){
+		printf("Error while reopening the skiplist with a torn log\n");
+		return false;
+	}
+	sl_close_mapped_skip_list(skp);
+
+	//A corrupted header isn't used:
+	fd = open(path, O_RDWR);
+	unsigned char header_byte = 0;
+	bool is_corrupted = fd >= 0  &&  pread(fd, &header_byte, 1, 12) == 1;
+	header_byte ^= 0xFF;
+	is_corrupted = is_corrupted  &&  pwrite(fd, &header_byte, 1, 12) == 1;
+	skp = sl_open_mapped_skip_list(path, layers);
+	if(!is_corrupted  ||  skp != NULL){
+		printf("Error while opening a corrupted skiplist\n");
+		return false;
+	}
+	header_byte ^= 0xFF;
+	is_corrupted = pwrite(fd, &header_byte, 1, 12) != 1;
+	close(fd);
+
+	//Neither is a truncated file:
+	if(is_corrupted  ||  truncate(path, file_size / 2) != 0  ||  (skp = sl_open_mapped_skip_list(path, layers)) != NULL){
+		printf("Error while opening a truncated skiplist\n");
+		return false;
+	}
+	unlink(path);
+
+	printf("\tnodes:\t\t\t\t%u\n", nodes);
+	printf("\tlayers:\t\t\t\t%d\n", layers);
+	printf("\tfile size:\t\t\t%zu bytes\n", file_size);
+	printf("\n");
+	printf("\ttime of the checkpoint:\t\t%.3lf μs\n", checkpoint_time);
+	printf("\ttime of dropping a torn log:\t%.3lf μs\n", recovery_time);
+	printf("\tcrash, torn log:\t\tlast checkpoint\n");
+	printf("\tcorrupted header, truncation:\trejected\n");
+
+	return true;
+}
+
+//Checks that skiplist holds exactly the keys 0 to nodes - 1 with their own key as value
+bool has_mapped_keys(sl_mapped_skip_list* skiplist, unsigned int nodes){
+	if(skiplist == NULL  ||  sl_mapped_get_node_count(skiplist) != nodes)
+		return false;
+	for(unsigned int j = 0; j < nodes; j++){
+		uint64_t value;
+		if(!sl_mapped_get_value(skiplist, j, &value)  ||  value != j)
+			return false;
+	}
+	return !sl_mapped_get_value(skiplist, nodes, NULL);
+}
+int start_cache_miss_counter(){
+	//Count the cache misses of this thread in user space, -1 if the machine has no hardware counters:
+	struct perf_event_attr attributes;
+	memset(&attributes, 0, sizeof(attributes));
+	attributes.size = sizeof(attributes);
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+	attributes.disabled = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+	int counter = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+	if(counter != -1){
+		ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+		ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+	}
+	return counter;
+}
+long long stop_cache_miss_counter(int counter){
+	//Returns -1 without hardware counters:
+	long long cache_misses = -1;
+	if(counter == -1)
+		return -1;
+	ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+	if(read(counter, &cache_misses, sizeof(cache_misses)) != sizeof(cache_misses))
+		cache_misses = -1;
+	close(counter);
+	return cache_misses;
+}
+void print_cache_misses(long long cache_misses, unsigned int lookups){
+	if(cache_misses != -1)
+		printf("\tcache misses per search:\t%.2lf\n", (double)cache_misses / (double)lookups);
+	else
+		printf("\tcache misses per search:\tno hardware counters\n");
+}
@@ -1,9 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
 #include <time.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
 #include "skiplist.h"
+#include "skiplist_random.h"
 
 /*****************************************************************/
 /*********************** (Key) Color Defines *********************/
@@ -23,18 +29,297 @@
 #define KEY_COLOR CCYN
 #endif /*KEY_COLOR*/
 
+//p * 2^32 for p = 1/e:
+#define SL_P_INV_E_THRESHOLD 1580030169ULL
+
+/*****************************************************************/
+/************************* Slab Allocator ************************/
+/*****************************************************************/
+
+//Size of the first slab of a size class, every further slab is twice as big up to SLAB_MAXIMUM_BYTES:
+#ifndef SLAB_MINIMUM_BYTES
+#define SLAB_MINIMUM_BYTES 4096
+#endif /*SLAB_MINIMUM_BYTES*/
+
+#ifndef SLAB_MAXIMUM_BYTES
+#define SLAB_MAXIMUM_BYTES 262144
+#endif /*SLAB_MAXIMUM_BYTES*/
+
+//slab, the nodes are located behind the header
+typedef struct _sl_slab{
+	struct _sl_slab* next_slab;
+	size_t node_capacity;
+	//Keeps the nodes behind the header aligned:
+	max_align_t nodes[];
+}sl_slab;
+
+//size class, holds all nodes of one height
+typedef struct _sl_slab_class{
+	sl_slab* first_slab;
+	sl_slab* current_slab;
+	//Amount of nodes that were handed out of current_slab so far:
+	size_t used_in_current_slab;
+	//Removed nodes, linked by next_in_layer[0]:
+	sl_node* free_nodes;
+	size_t next_slab_bytes;
+}sl_slab_class;
+
+/*****************************************************************/
+/************************** Statistics ***************************/
+/*****************************************************************/
+
+//Statements that only count for sl_get_stats(), they're left out without SL_STATISTICS:
+#ifdef SL_STATISTICS
+#define SL_COUNT(...) __VA_ARGS__
+#else
+#define SL_COUNT(...)
+#endif /*SL_STATISTICS*/
+
+//Counts calls of public functions, e.g. SL_COUNT_OPERATIONS(skiplist, searches, 1). Functions that hand a key
+//to another public function leave the counting to it:
+#define SL_COUNT_OPERATIONS(skiplist, counter, amount) SL_COUNT(__atomic_fetch_add(&(skiplist)->counters.counter, (amount), __ATOMIC_RELAXED))
+
+//counts of one search, they're added to the counters of the skip list when the search ends
+typedef struct{
+	unsigned int comparisons;
+	unsigned int visited_nodes;
+}sl_search_counts;
+
+/*****************************************************************/
+/********************** Interleaved Searches *********************/
+/*****************************************************************/
+
+//Amount of searches sl_get_many() keeps in flight, the others work while one waits for its next node:
+#ifndef SL_GET_MANY_STREAMS
+#define SL_GET_MANY_STREAMS 8
+#endif /*SL_GET_MANY_STREAMS*/
+
+//search of sl_get_many(), the node it looks at next is prefetched and only read at its next turn
+typedef struct{
+	//Position of the searched key in the batch:
+	unsigned int index;
+	int layer;
+	sl_node* current_node;
+	//Without SL_SUCCESSOR_KEYS: current_node->next_in_layer[layer]
+	sl_node* next_node;
+#ifdef SL_STATISTICS
+	sl_search_counts counts;
+#endif /*SL_STATISTICS*/
+}sl_search_stream;
+
+/*****************************************************************/
+/***************************** Files *****************************/
+/*****************************************************************/
+
+//Bytes that sl_save() and sl_load() move with one write() or read():
+#ifndef SL_FILE_BUFFER_BYTES
+#define SL_FILE_BUFFER_BYTES 1048576
+#endif /*SL_FILE_BUFFER_BYTES*/
+
+//Identifies files of sl_save(), the last character is the version of the format:
+#define SL_FILE_MAGIC "SKL1"
+
+//header of files of sl_save(), followed by node_count records in increasing key order:
+//key (uint32_t), height (uint8_t) and with has_payloads the payload size (uint32_t) and payload
+typedef struct{
+	char magic[4];
+	uint32_t layer_count;
+	uint32_t flags;
+	uint32_t probability;
+	uint32_t node_count;
+	uint32_t has_payloads;
+}sl_file_header;
+
+//buffer of sl_save() and sl_load()
+typedef struct{
+	int fd;
+	//Saving: bytes waiting to be written. Loading: bytes read so far and bytes that were handed out of them:
+	size_t used;
+	size_t position;
+	unsigned char bytes[SL_FILE_BUFFER_BYTES];
+}sl_file_buffer;
+
 /*****************************************************************/
 /************************ Private Functions **********************/
 /*****************************************************************/
 
+unsigned int get_growth_threshold(sl_probability probability){
+	//1/p rounded:
+	switch(probability){
+		case SL_P_QUARTER:
+			return 4;
+		case SL_P_INV_E:
+			return 3;
+		default: /* SL_P_HALF */
+			return 2;
+	}
+}
+
 void increment_node_counts(sl_skip_list* skiplist, unsigned int highest_layer){
+	//Every change of the structure invalidates the paths of all fingers:
+	skiplist->version++;
+
 	for(int i = 0; i <= highest_layer; i++)
 		skiplist->node_count_in_layer[i]++;
+
+	//Raise top_layer when a layer above gets a node behind zero_node:
+	while(skiplist->top_layer < skiplist->layer_count - 1  &&  skiplist->node_count_in_layer[skiplist->top_layer + 1] > 1)
+		skiplist->top_layer++;
+
+	//Let new nodes reach the next layer when the highest allowed layer holds more than 1/p nodes:
+	if(skiplist->flags & SL_DYNAMIC_LAYERS){
+		while(skiplist->height_limit < skiplist->layer_count - 1  &&
+			  skiplist->node_count_in_layer[skiplist->height_limit] > get_growth_threshold(skiplist->probability))
+			skiplist->height_limit++;
+	}
 }
 
 void decrement_node_counts(sl_skip_list* skiplist, unsigned int highest_layer){
+	//Every change of the structure invalidates the paths of all fingers:
+	skiplist->version++;
+
 	for(int i = 0; i <= highest_layer; i++)
 		skiplist->node_count_in_layer[i]--;
+
+	//Lower top_layer when only zero_node is left in it:
+	while(skiplist->top_layer > 0  &&  skiplist->node_count_in_layer[skiplist->top_layer] <= 1)
+		skiplist->top_layer--;
+}
+
+#ifdef SL_STATISTICS
+void record_search(sl_skip_list* skiplist, const sl_search_counts* counts){
+	//Readers of other modules search at the same time under a shared lock, relaxed additions are enough for counters:
+	sl_counters* counters = &skiplist->counters;
+	__atomic_fetch_add(&counters->comparisons, counts->comparisons, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&counters->visited_nodes, counts->visited_nodes, __ATOMIC_RELAXED);
+
+	unsigned int bucket = counts->visited_nodes < SL_SEARCH_LENGTH_BUCKETS ? counts->visited_nodes : SL_SEARCH_LENGTH_BUCKETS - 1;
+	__atomic_fetch_add(&counters->search_lengths[bucket], 1, __ATOMIC_RELAXED);
+}
+#endif /*SL_STATISTICS*/
+
+void* default_allocate(size_t size, void* context){
+	return malloc(size);
+}
+
+void default_release(void* pointer, void* context){
+	free(pointer);
+}
+
+size_t get_node_size(sl_skip_list* skiplist, unsigned int height){
+	//A node of height h is part of the layers 0 to h:
+	size_t node_size = sizeof(sl_node) + sizeof(sl_node*) * (height + 1);
+
+	//Indexable skip lists store the width of every next_in_layer pointer behind the pointers:
+	if(skiplist->flags & SL_INDEXABLE)
+		node_size += sizeof(unsigned int) * (height + 1);
+
+	//Successor keys are stored behind the pointers and the widths:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS)
+		node_size += sizeof(unsigned int) * (height + 1);
+
+	//Nodes of a slab lie one after another, keep every node aligned like its pointers:
+	return (node_size + sizeof(sl_node*) - 1) / sizeof(sl_node*) * sizeof(sl_node*);
+}
+
+unsigned int* get_widths(sl_node* node){
+	//Amount of steps in layer 0 from node to next_in_layer[i], or to behind the last node if it's NULL:
+	return (unsigned int*)&node->next_in_layer[node->height + 1];
+}
+
+unsigned int* get_successor_keys(sl_skip_list* skiplist, sl_node* node){
+	//Key of next_in_layer[i], or UINT_MAX if it's NULL. Behind the widths of indexable skip lists:
+	unsigned int* successor_keys = (unsigned int*)&node->next_in_layer[node->height + 1];
+	if(skiplist->flags & SL_INDEXABLE)
+		successor_keys += node->height + 1;
+	return successor_keys;
+}
+
+unsigned int get_distance(sl_node* from_node, sl_node* to_node, int layer){
+	//Sum up the widths from from_node to to_node in layer:
+	unsigned int distance = 0;
+	while(from_node != to_node){
+		distance += get_widths(from_node)[layer];
+		from_node = from_node->next_in_layer[layer];
+	}
+	return distance;
+}
+
+sl_node* allocate_slab_node(sl_skip_list* skiplist, unsigned int height){
+	sl_slab_class* size_class = &skiplist->slab_classes[height];
+	size_t node_size = get_node_size(skiplist, height);
+
+	//Reuse a removed node first:
+	if(size_class->free_nodes != NULL){
+		sl_node* node = size_class->free_nodes;
+		size_class->free_nodes = node->next_in_layer[0];
+		return node;
+	}
+
+	//Go to the next slab if current slab is full. After sl_clear_skip_list() that slab does already exist:
+	if(size_class->current_slab == NULL  ||  size_class->used_in_current_slab == size_class->current_slab->node_capacity){
+		sl_slab* next_slab = size_class->current_slab == NULL ? size_class->first_slab : size_class->current_slab->next_slab;
+
+		if(next_slab == NULL){
+			size_t slab_bytes = size_class->next_slab_bytes;
+			//A slab holds at least one node:
+			if(slab_bytes < sizeof(sl_slab) + node_size)
+				slab_bytes = sizeof(sl_slab) + node_size;
+
+			next_slab = skiplist->allocator.allocate(slab_bytes, skiplist->allocator.context);
+			//In case the allocator returned NULL, we need to avoid null references:
+			if(next_slab == NULL)
+				return NULL;
+			skiplist->allocated_bytes += slab_bytes;
+
+			next_slab->next_slab = NULL;
+			next_slab->node_capacity = (slab_bytes - sizeof(sl_slab)) / node_size;
+
+			//Append the new slab:
+			if(size_class->current_slab == NULL)
+				size_class->first_slab = next_slab;
+			else
+				size_class->current_slab->next_slab = next_slab;
+
+			if(size_class->next_slab_bytes < SLAB_MAXIMUM_BYTES)
+				size_class->next_slab_bytes *= 2;
+		}
+		size_class->current_slab = next_slab;
+		size_class->used_in_current_slab = 0;
+	}
+
+	//Hand out the next unused node of current slab:
+	return (sl_node*)((char*)size_class->current_slab->nodes + node_size * size_class->used_in_current_slab++);
+}
+
+void release_slab_node(sl_skip_list* skiplist, sl_node* node){
+	sl_slab_class* size_class = &skiplist->slab_classes[node->height];
+
+	//Push the node on the free list of its size class:
+	node->next_in_layer[0] = size_class->free_nodes;
+	size_class->free_nodes = node;
+}
+
+void release_slabs(sl_skip_list* skiplist){
+	for(int i = 0; i < skiplist->layer_count; i++){
+		sl_slab* current_slab = skiplist->slab_classes[i].first_slab;
+		sl_slab* next_slab;
+
+		while(current_slab != NULL){
+			next_slab = current_slab->next_slab;
+			skiplist->allocator.release(current_slab, skiplist->allocator.context);
+			current_slab = next_slab;
+		}
+	}
+}
+
+void reset_slabs(sl_skip_list* skiplist){
+	//Start handing out the nodes of the first slab again, the memory of all slabs is kept:
+	for(int i = 0; i < skiplist->layer_count; i++){
+		skiplist->slab_classes[i].current_slab = NULL;
+		skiplist->slab_classes[i].used_in_current_slab = 0;
+		skiplist->slab_classes[i].free_nodes = NULL;
+	}
 }
 
 int get_digits(unsigned int num){
@@ -49,18 +334,35 @@ int get_digits(unsigned int num){
 	return digits;
 }
 
-unsigned int get_random_int(unsigned int maximum){
-	unsigned int rnd = 0;
+unsigned int get_random_height(uint64_t* state, sl_probability probability, unsigned int maximum){
+	unsigned int height;
 
-	//Set seed:
-	srand((unsigned int) time(0) - (unsigned int) clock());
+	//Generate random integers with geometric distribution X~G(p), the last instance (maximum)
+	//gets the probability of all greater instances --> sum of all probabilities = 1:
+	switch(probability){
+		case SL_P_QUARTER:
+			//Every layer needs two zero bits:
+			height = sl_random_trailing_zeros(sl_random_word(state)) / 2;
+			break;
 
-	//Generate random integers with geometric distribution X~G(p=0,5),
-	//last instance has same probability as forelast instance --> sum of all probabilities = 1:
-	while(rnd < maximum && (rand() % 2) == 0)
-		rnd++;
+		case SL_P_INV_E:
+			//1/e isn't a power of 2, compare 32 bit chunks against p * 2^32 instead:
+			height = 0;
+			while(height < maximum){
+				uint64_t word = sl_random_word(state);
+				if((word & 0xFFFFFFFF) >= SL_P_INV_E_THRESHOLD)
+					break;
+				height++;
+				if(height == maximum  ||  (word >> 32) >= SL_P_INV_E_THRESHOLD)
+					break;
+				height++;
+			}
+			break;
 
-	return rnd;
+		default: /* SL_P_HALF */
+			return sl_random_height(state, maximum);
+	}
+	return height < maximum ? height : maximum;
 }
 
 char* strcpy_spaces(int count){
@@ -73,296 +375,839 @@ char* strcpy_spaces(int count){
 	return str;
 }
 
-sl_node* create_node(sl_skip_list* skiplist, unsigned int key, void* data){
-	sl_node* node = calloc(1, sizeof(sl_node) + sizeof(sl_node*) * skiplist->layer_count);
-	//In case calloc() returned NULL, we need to avoid null references:
+sl_node* create_node(sl_skip_list* skiplist, unsigned int key, void* data, unsigned int height){
+	sl_node* node;
+
+	//Only allocate the pointers of the layers this node is part of:
+	if(skiplist->slab_classes != NULL){
+		node = allocate_slab_node(skiplist, height);
+	}
+	else{
+		node = skiplist->allocator.allocate(get_node_size(skiplist, height), skiplist->allocator.context);
+		if(node != NULL)
+			skiplist->allocated_bytes += get_node_size(skiplist, height);
+	}
+	//In case the allocator returned NULL, we need to avoid null references:
 	if(node == NULL)
 		return node;
 	node->key = key;
+	node->height = height;
 	node->data = data;
 	//Shouldn't rely on the machine interpreting that 0ed bits mean NULL:
-	for(int i = 0; i < skiplist->layer_count; i++)
+	for(int i = 0; i <= height; i++)
 		node->next_in_layer[i] = NULL;
+	//A new node is the only node behind itself:
+	if(skiplist->flags & SL_INDEXABLE){
+		for(int i = 0; i <= height; i++)
+			get_widths(node)[i] = 1;
+	}
+	//UINT_MAX is never smaller than a searched key, like the end of a layer:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		for(int i = 0; i <= height; i++)
+			get_successor_keys(skiplist, node)[i] = UINT_MAX;
+	}
 	return node;
 }
 
-/*****************************************************************/
-/************************ Public Functions ***********************/
-/*****************************************************************/
+void free_node(sl_skip_list* skiplist, sl_node* node){
+	//Nodes of a slab stay allocated until the skip list is removed:
+	if(skiplist->slab_classes != NULL){
+		release_slab_node(skiplist, node);
+	}
+	else{
+		skiplist->allocated_bytes -= get_node_size(skiplist, node->height);
+		skiplist->allocator.release(node, skiplist->allocator.context);
+	}
+}
 
-bool sl_insert_node_static(sl_skip_list* skiplist, unsigned int key, void* data, unsigned int height){
-	//Check whether parameter height is valid:
-	if(height > skiplist->layer_count - 1)
-		return false;
+sl_node* search_from(sl_skip_list* skiplist, sl_node* current_node, int start_layer, unsigned int key, sl_node** update){
+	//Node pointer that points to the next node in the current layer:
+	sl_node* next_node = NULL;
+	SL_COUNT(sl_search_counts counts = { 0, 0 });
 
-	//Create the node that shall be inserted:
-	sl_node* new_node = create_node(skiplist, key, data);
-	//Check whether memory allocation at create_node() worked:
-	if(new_node == NULL)
-		return false;
+	//Compare with the copies of the next keys, only the nodes that are moved to get loaded:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		for(int current_layer = start_layer; current_layer >= 0; current_layer--){
+			while(get_successor_keys(skiplist, current_node)[current_layer] < key){
+				SL_COUNT(counts.comparisons++; counts.visited_nodes++);
+				current_node = current_node->next_in_layer[current_layer];
+			}
+			//The copy of the end of a layer (UINT_MAX) is compared too:
+			SL_COUNT(counts.comparisons++);
+			update[current_layer] = current_node;
+		}
+		SL_COUNT(record_search(skiplist, &counts));
+		return current_node->next_in_layer[0];
+	}
 
-	//Case 1: empty skip list, insert the first node
-	if (skiplist->zero_node == NULL){
-		new_node->height = skiplist->layer_count - 1;
-		skiplist->zero_node = new_node;
-		increment_node_counts(skiplist, skiplist->layer_count - 1);
+	//Search layer-wise, start at start_layer and store the last node in front of key for every layer:
+	for(int current_layer = start_layer; current_layer >= 0; current_layer--){
+		next_node = current_node->next_in_layer[current_layer];
+		while(next_node != NULL  &&  next_node->key < key){
+			SL_COUNT(counts.comparisons++; counts.visited_nodes++);
+			current_node = next_node;
+			next_node = current_node->next_in_layer[current_layer];
+		}
+		//The node that stopped the search in this layer was compared too:
+		SL_COUNT(counts.comparisons += next_node != NULL);
+		update[current_layer] = current_node;
 	}
-	//Case 2: new_node is located behind the zero_node
-	else if(new_node->key > skiplist->zero_node->key){
-		new_node->height = height;
+	SL_COUNT(record_search(skiplist, &counts));
+	//Return the first node in layer 0 whose key is >= key (may be NULL):
+	return next_node;
+}
 
-		//Node pointer that points to the current node in the current layer:
-		sl_node* current_node = skiplist->zero_node;
-		//Node pointer that points to the next node in the current layer:
-		sl_node* next_node;
+sl_node* find_predecessors(sl_skip_list* skiplist, unsigned int key, sl_node** update){
+	//Layers above top_layer only contain zero_node:
+	for(int i = skiplist->top_layer + 1; i < skiplist->layer_count; i++)
+		update[i] = skiplist->zero_node;
 
-		//Search and insert layer-wise:
-		for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
-			//Get next node in the current layer:
+	//Start at highest non-empty layer:
+	return search_from(skiplist, skiplist->zero_node, skiplist->top_layer, key, update);
+}
+
+sl_node* find_first_node(sl_skip_list* skiplist, unsigned int key){
+	//Check whether skip list is empty or key is located at or in front of zero_node:
+	if(skiplist->zero_node == NULL  ||  key <= skiplist->zero_node->key)
+		return skiplist->zero_node;
+
+	//Node pointer that points to the current node in the current layer:
+	sl_node* current_node = skiplist->zero_node;
+	//Node pointer that points to the next node in the current layer:
+	sl_node* next_node = NULL;
+	SL_COUNT(sl_search_counts counts = { 0, 0 });
+
+	//Search layer-wise for the last node in front of key, start at highest non-empty layer:
+	for(int current_layer = skiplist->top_layer; current_layer >= 0; current_layer--){
+		next_node = current_node->next_in_layer[current_layer];
+		while(next_node != NULL  &&  next_node->key < key){
+			SL_COUNT(counts.comparisons++; counts.visited_nodes++);
+			current_node = next_node;
 			next_node = current_node->next_in_layer[current_layer];
-			
-			//Case 2.1: new_node is located behind the last node in current layer
-			if(next_node == NULL){
-				//Check whether the new node should be inserted in the current layer:
-				if(current_layer <= height){
-					//Insert new node at current layer: Reset the pointer of current node
-					// to point at the new node in the current layer
-					current_node->next_in_layer[current_layer] = new_node;
-				}
-				//Drop down one layer:
-				//continue;
-			}
+		}
+		SL_COUNT(counts.comparisons += next_node != NULL);
+	}
+	SL_COUNT(record_search(skiplist, &counts));
+	//Return the first node whose key is >= key (may be NULL):
+	return next_node;
+}
 
-			//Case 2.2: new node is located after zero_node and in front of last node
-			else if(new_node->key < next_node->key){
-
-				//Check whether the new node should be inserted in the current layer:
-				if(current_layer <= height){
-					//Insert new node at current layer: Reset the pointer of current node
-					// to point at the new node in the current layer:
-					current_node->next_in_layer[current_layer] = new_node;
-					//Set the pointer of new node to point at the next node in the current layer:
-					new_node->next_in_layer[current_layer] = next_node;
-				}
-				//Drop down one layer:
-				//continue;
-			}
-			else if(new_node->key > next_node->key){
-				//Go to the next node in the current layer:
+sl_node* find_node(sl_skip_list* skiplist, unsigned int key, sl_search_counts* counts){
+	//Node pointer that points to the current node in the current layer:
+	sl_node* current_node = skiplist->zero_node;
+
+	//Search with the copies of the next keys, only the found node and the nodes in front of it get loaded:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		if(key == current_node->key)
+			return current_node;
+		for(int current_layer = skiplist->top_layer; current_layer >= 0; current_layer--){
+			unsigned int* successor_keys = get_successor_keys(skiplist, current_node);
+			while(successor_keys[current_layer] < key){
+				SL_COUNT(counts->comparisons++; counts->visited_nodes++);
 				current_node = current_node->next_in_layer[current_layer];
+				successor_keys = get_successor_keys(skiplist, current_node);
+			}
+			SL_COUNT(counts->comparisons++);
+			//UINT_MAX is also the copy of NULL:
+			if(successor_keys[current_layer] == key  &&  current_node->next_in_layer[current_layer] != NULL)
+				return current_node->next_in_layer[current_layer];
+		}
+		return NULL;
+	}
 
-				//Increment current_layer to stay in current layer because the for-loop decrements current_layer:
-				current_layer++;
+	//Search layer-wise, start at highest non-empty layer:
+	for(int current_layer = skiplist->top_layer; current_layer >= 0; current_layer--){
+		//Check whether wanted node was found:
+		if(key == current_node->key){
+			return current_node;
+		}
+		//Check whether wanted node isn't located in current layer
+		else if(current_node->next_in_layer[current_layer] == NULL ||
+				current_node->next_in_layer[current_layer]->key > key){
+			SL_COUNT(counts->comparisons += current_node->next_in_layer[current_layer] != NULL);
+			//Drop one layer down:
+			//continue;
+		}
+		else /*(key >= current_node->next_in_layer[current_layer]->key)*/{
+			SL_COUNT(counts->comparisons++; counts->visited_nodes++);
+			//Go to the next node in the current layer:
+			current_node = current_node->next_in_layer[current_layer];
+			//Increment current_layer to stay in current layer because the for-loop decrements current_layer:
+			current_layer++;
+			//continue;
+		}	
+	}
+	return NULL;
+}
 
-				//continue;
-			}
-			//Key of new node does already exist in skip list: overwrite the old node
-			else /* new_node->key == next_node->key */{
+void find_last_nodes_in_layer(sl_node* current_node, int layer, unsigned int maximum_key, sl_node** last_node){
+	//Go forward while the next node is still in the range:
+	while(current_node->next_in_layer[layer] != NULL  &&  current_node->next_in_layer[layer]->key <= maximum_key)
+		current_node = current_node->next_in_layer[layer];
+	last_node[layer] = current_node;
+}
+
+void find_last_nodes(sl_skip_list* skiplist, sl_node* current_node, unsigned int maximum_key, sl_node** last_node){
+	//Layers above top_layer only contain zero_node:
+	for(int i = skiplist->top_layer + 1; i < skiplist->layer_count; i++)
+		last_node[i] = skiplist->zero_node;
+
+	//Search layer-wise for the last node whose key is <= maximum_key, start at highest non-empty layer:
+	for(int current_layer = skiplist->top_layer; current_layer >= 0; current_layer--){
+		find_last_nodes_in_layer(current_node, current_layer, maximum_key, last_node);
+		current_node = last_node[current_layer];
+	}
+}
+
+unsigned int remove_run(sl_skip_list* skiplist, sl_node* first_node, sl_node* last_node, sl_visit_function release, void* context){
+	//The run from first_node to last_node is already unlinked in every layer, free it in one sweep through layer 0:
+	sl_node* current_node = first_node;
+	sl_node* next_node;
+	unsigned int removed_count = 0;
 
-				//Remove the node with this key because we could have changed some pointers 
-				// before we knew that we will "overwrite" this node:
-				if(!sl_remove_node(skiplist, key))
-					return false;
+	while(true){
+		//Get next node before current node is freed:
+		next_node = current_node->next_in_layer[0];
+		bool is_last_node = current_node == last_node;
 
-				//Free new_node after calling sl_remove_node() otherwise the skip list wouldn't be connected correctly:
-				free(new_node);
+		if(release != NULL)
+			release(current_node, context);
+		decrement_node_counts(skiplist, current_node->height);
+		free_node(skiplist, current_node);
+		removed_count++;
 
-				if(!sl_insert_node_static(skiplist, key, data, height))
-					return false;
-				
-				//Decrement node counts because sl_insert_node_static() did increment it:
-				decrement_node_counts(skiplist, height);
+		if(is_last_node)
+			break;
+		current_node = next_node;
+	}
+	return removed_count;
+}
+
+bool is_predecessor(sl_node* node, int layer, unsigned int key){
+	//node is the last node in front of key in this layer:
+	return node->key < key  &&  (node->next_in_layer[layer] == NULL  ||  node->next_in_layer[layer]->key >= key);
+}
+
+sl_node* find_predecessors_from(sl_skip_list* skiplist, unsigned int key, sl_node** path){
+	//path holds the last node in front of a previous key for every layer. Go up until the node in
+	//the layer above is also in front of key, all higher layers are correct then too:
+	int layer = 0;
+	while(layer < skiplist->top_layer  &&  !is_predecessor(path[layer + 1], layer + 1, key))
+		layer++;
+
+	//Start at the old path node if it is in front of key, otherwise at the one of the layer above:
+	sl_node* start_node;
+	if(path[layer]->key < key)
+		start_node = path[layer];
+	else if(layer < skiplist->top_layer)
+		start_node = path[layer + 1];
+	else
+		start_node = skiplist->zero_node;
+
+	//Go down again and update path:
+	return search_from(skiplist, start_node, layer, key, path);
+}
 
+bool start_search_stream(sl_skip_list* skiplist, const unsigned int* keys, unsigned int index, sl_node** nodes, sl_search_stream* stream){
+	//Keys at or in front of zero_node don't need a search:
+	if(keys[index] <= skiplist->zero_node->key){
+		nodes[index] = keys[index] == skiplist->zero_node->key ? skiplist->zero_node : NULL;
+		return false;
+	}
+
+	//Start at highest non-empty layer, zero_node is used by every search and stays in the cache:
+	stream->index = index;
+	stream->layer = skiplist->top_layer;
+	stream->current_node = skiplist->zero_node;
+	stream->next_node = skiplist->zero_node->next_in_layer[stream->layer];
+	SL_COUNT(stream->counts = (sl_search_counts){ 0, 0 });
+	__builtin_prefetch(stream->next_node);
+	return true;
+}
+
+bool step_search_stream(sl_skip_list* skiplist, const unsigned int* keys, sl_node** nodes, sl_search_stream* stream){
+	unsigned int key = keys[stream->index];
+
+	//The copies of the next keys lie in current_node, drop down until the search has to move to another node:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		unsigned int* successor_keys = get_successor_keys(skiplist, stream->current_node);
+		while(true){
+			SL_COUNT(stream->counts.comparisons++);
+			if(successor_keys[stream->layer] < key){
+				SL_COUNT(stream->counts.visited_nodes++);
+				stream->current_node = stream->current_node->next_in_layer[stream->layer];
+				__builtin_prefetch(stream->current_node);
+				return false;
+			}
+			//UINT_MAX is also the copy of NULL:
+			if(successor_keys[stream->layer] == key  &&  stream->current_node->next_in_layer[stream->layer] != NULL){
+				nodes[stream->index] = stream->current_node->next_in_layer[stream->layer];
+				SL_COUNT(record_search(skiplist, &stream->counts));
+				return true;
+			}
+			if(stream->layer == 0){
+				nodes[stream->index] = NULL;
+				SL_COUNT(record_search(skiplist, &stream->counts));
 				return true;
 			}
-			
+			stream->layer--;
 		}
-		//new_node was inserted successfully -> increment node_counts of the skip list
-		increment_node_counts(skiplist, height);
 	}
 
-	//Case 3: new_node is located at zero_node
-	else if(new_node->key == skiplist->zero_node->key){
-		//Just overwrite the data pointer of zero_node:
-		skiplist->zero_node->data = new_node->data;
-		//Free new_node because it's dispensable:
-		free(new_node);
+	//next_node was prefetched at the last turn:
+	sl_node* next_node = stream->next_node;
+	SL_COUNT(stream->counts.comparisons += next_node != NULL);
+	if(next_node != NULL  &&  next_node->key <= key){
+		if(next_node->key == key){
+			nodes[stream->index] = next_node;
+			SL_COUNT(record_search(skiplist, &stream->counts));
+			return true;
+		}
+		//Go to the next node in the current layer:
+		SL_COUNT(stream->counts.visited_nodes++);
+		stream->current_node = next_node;
+	}
+	//Drop one layer down, the search ends behind layer 0:
+	else if(--stream->layer < 0){
+		nodes[stream->index] = NULL;
+		SL_COUNT(record_search(skiplist, &stream->counts));
+		return true;
 	}
 
-	//Case 4: new_node is located in front of zero_node
-	else /*new_node->key < skiplist->zero_node->key*/{
-		//Store key and data pointer of zero_node to insert them later as node:
-		int temp_key = skiplist->zero_node->key;
-		void* temp_data = skiplist->zero_node->data;
+	stream->next_node = stream->current_node->next_in_layer[stream->layer];
+	__builtin_prefetch(stream->next_node);
+	return false;
+}
 
-		//new_node gets set as zero_node:
-		skiplist->zero_node->key = new_node->key;
-		skiplist->zero_node->data = new_node->data;
+void link_node(sl_skip_list* skiplist, sl_node** update, sl_node* new_node){
+	//Insert new_node behind its predecessor in every layer it's part of:
+	for(int i = 0; i <= new_node->height; i++){
+		new_node->next_in_layer[i] = update[i]->next_in_layer[i];
+		update[i]->next_in_layer[i] = new_node;
+	}
 
-		//Insert the old zero_node with a random height because there is no given
-		//information in which height the old zero_node should be inserted:
-		if(!sl_insert_node_static(skiplist, temp_key, temp_data, get_random_int(skiplist->layer_count - 1)))
-			return false;
+	//new_node takes over the successor keys of its predecessors:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		for(int i = 0; i <= new_node->height; i++){
+			get_successor_keys(skiplist, new_node)[i] = get_successor_keys(skiplist, update[i])[i];
+			get_successor_keys(skiplist, update[i])[i] = new_node->key;
+		}
+	}
 
-		//Free new_node because it's dispensable:
-		free(new_node);
+	if(skiplist->flags & SL_INDEXABLE){
+		//Steps from the predecessor in the current layer to new_node, the predecessor in the layer below
+		//is reached by walking the layer below:
+		unsigned int offset = 1;
+		for(int i = 0; i <= new_node->height; i++){
+			if(i > 0)
+				offset += get_distance(update[i], update[i - 1], i - 1);
+			get_widths(new_node)[i] = get_widths(update[i])[i] - offset + 1;
+			get_widths(update[i])[i] = offset;
+		}
+		//The pointers above new_node jump over one more node:
+		for(int i = new_node->height + 1; i < skiplist->layer_count; i++)
+			get_widths(update[i])[i]++;
+	}
+}
 
-		//increment_node_counts() isn't necessary because sl_insert_node_static() does already increment:
+void unlink_node(sl_skip_list* skiplist, sl_node** update, sl_node* remove_node){
+	//Let the predecessors point at the successors of remove_node in every layer it's part of:
+	for(int i = 0; i <= remove_node->height; i++)
+		update[i]->next_in_layer[i] = remove_node->next_in_layer[i];
+
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		for(int i = 0; i <= remove_node->height; i++)
+			get_successor_keys(skiplist, update[i])[i] = get_successor_keys(skiplist, remove_node)[i];
+	}
+
+	if(skiplist->flags & SL_INDEXABLE){
+		for(int i = 0; i <= remove_node->height; i++)
+			get_widths(update[i])[i] += get_widths(remove_node)[i] - 1;
+		//The pointers above remove_node jump over one node less:
+		for(int i = remove_node->height + 1; i < skiplist->layer_count; i++)
+			get_widths(update[i])[i]--;
 	}
-	return true;
 }
 
-bool sl_insert_node(sl_skip_list* skiplist, unsigned int key, void* data){
-	//Create the node that shall be inserted:
-	sl_node* new_node = create_node(skiplist, key, data);
-	//Check whether memory allocation in create_node() worked:
+void remove_zero_node(sl_skip_list* skiplist){
+	sl_node* zero_node = skiplist->zero_node;
+	sl_node* next_node = zero_node->next_in_layer[0];
+
+	//If skip list contains only one node, empty the skip list:
+	if(next_node == NULL){
+		decrement_node_counts(skiplist, zero_node->height);
+		skiplist->zero_node = NULL;
+		free_node(skiplist, zero_node);
+		return;
+	}
+
+	//The tower of next_node is too small to become the zero_node. Instead move its key and data into
+	//zero_node and unlink next_node. zero_node is its predecessor in every layer it's part of:
+	zero_node->key = next_node->key;
+	zero_node->data = next_node->data;
+	for(int i = 0; i <= next_node->height; i++)
+		zero_node->next_in_layer[i] = next_node->next_in_layer[i];
+	//No node points at zero_node, its new key doesn't need to be copied anywhere:
+	if(skiplist->flags & SL_SUCCESSOR_KEYS){
+		for(int i = 0; i <= next_node->height; i++)
+			get_successor_keys(skiplist, zero_node)[i] = get_successor_keys(skiplist, next_node)[i];
+	}
+
+	//Distances behind the new first node stay the same, the layers above lose one node:
+	if(skiplist->flags & SL_INDEXABLE){
+		for(int i = 0; i <= next_node->height; i++)
+			get_widths(zero_node)[i] = get_widths(next_node)[i];
+		for(int i = next_node->height + 1; i < skiplist->layer_count; i++)
+			get_widths(zero_node)[i]--;
+	}
+
+	decrement_node_counts(skiplist, next_node->height);
+	free_node(skiplist, next_node);
+}
+
+bool insert_behind_zero_node(sl_skip_list* skiplist, sl_node** update, sl_node* next_node, unsigned int key, void* data, unsigned int height){
+	//Create the node that shall be inserted, now that its height is known:
+	sl_node* new_node = create_node(skiplist, key, data, height);
+	//Check whether memory allocation at create_node() worked:
 	if(new_node == NULL)
 		return false;
 
-	//Generate a random height between 0 and (excluded) maximum height + 1:
-	int height = get_random_int(skiplist->layer_count - 1);	
+	//Key does already exist in skip list: replace the old node by the new node with the new height.
+	//update stays valid because the predecessors of both nodes are the same:
+	if(next_node != NULL  &&  next_node->key == key){
+		unlink_node(skiplist, update, next_node);
+		decrement_node_counts(skiplist, next_node->height);
+		free_node(skiplist, next_node);
+	}
+
+	link_node(skiplist, update, new_node);
+	//new_node was inserted successfully -> increment node_counts of the skip list
+	increment_node_counts(skiplist, height);
+	return true;
+}
+
+sl_node* upsert(sl_skip_list* skiplist, unsigned int key, void* data, bool replace_data, bool* is_inserted){
+	sl_node* zero_node = skiplist->zero_node;
+	sl_node* found_node = NULL;
+	//Last node in front of the new node for every layer:
+	sl_node* update[skiplist->layer_count];
+	SL_COUNT_OPERATIONS(skiplist, insertions, 1);
+
+	//Find the key with one search, zero_node is checked first:
+	if(zero_node != NULL  &&  key == zero_node->key){
+		found_node = zero_node;
+	}
+	else if(zero_node != NULL  &&  key > zero_node->key){
+		sl_node* next_node = find_predecessors(skiplist, key, update);
+		if(next_node != NULL  &&  next_node->key == key)
+			found_node = next_node;
+	}
 
-	//Case 1: empty skip list, insert the first node
-	if (skiplist->zero_node == NULL){
-		new_node->height = skiplist->layer_count - 1;
+	//Key does already exist in skip list: nothing to allocate
+	if(found_node != NULL){
+		if(replace_data)
+			found_node->data = data;
+		if(is_inserted != NULL)
+			*is_inserted = false;
+		return found_node;
+	}
+
+	//Empty skip list: the first node gets maximum height
+	if(zero_node == NULL){
+		sl_node* new_node = create_node(skiplist, key, data, skiplist->layer_count - 1);
+		if(new_node == NULL)
+			return NULL;
 		skiplist->zero_node = new_node;
 		increment_node_counts(skiplist, skiplist->layer_count - 1);
+		if(is_inserted != NULL)
+			*is_inserted = true;
+		return new_node;
 	}
-	//Case 2: new_node is located behind the zero_node
-	else if(new_node->key > skiplist->zero_node->key){
-		new_node->height = height;
 
-		//Node pointer that points to the current node in the current layer:
-		sl_node* current_node = skiplist->zero_node;
-		//Node pointer that points to the next node in the current layer:
-		sl_node* next_node;
+	sl_node* new_node = create_node(skiplist, key, data, get_random_height(&skiplist->random_state, skiplist->probability, skiplist->height_limit));
+	//Check whether memory allocation at create_node() worked:
+	if(new_node == NULL)
+		return NULL;
 
-		//Search and insert layer-wise:
-		for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
-			//Get next node in current layer:
-			next_node = current_node->next_in_layer[current_layer];
-			
-			//Case 2.1: new_node is located behind the last node in current layer
-			if(next_node == NULL){
-				//Check whether the new node should be inserted in the current layer:
-				if(current_layer <= height){
-					//Insert new node at current layer: Reset the pointer of current node
-					// to point at the new node in the current layer:
-					current_node->next_in_layer[current_layer] = new_node;
-				}
-				//Drop one layer down:
-				//continue;
-			}
+	//Key is located in front of zero_node: zero_node takes the new key and data, the old ones move into
+	//new_node directly behind zero_node, so zero_node is its predecessor in every layer:
+	sl_node* result_node = new_node;
+	if(key < zero_node->key){
+		new_node->key = zero_node->key;
+		new_node->data = zero_node->data;
+		zero_node->key = key;
+		zero_node->data = data;
+		for(int i = 0; i < skiplist->layer_count; i++)
+			update[i] = zero_node;
+		result_node = zero_node;
+	}
+
+	link_node(skiplist, update, new_node);
+	increment_node_counts(skiplist, new_node->height);
+	if(is_inserted != NULL)
+		*is_inserted = true;
+	return result_node;
+}
+
+bool remove_behind_zero_node(sl_skip_list* skiplist, sl_node** update, sl_node* remove_node, unsigned int key){
+	//Check whether the key isn't in this skip list:
+	if(remove_node == NULL  ||  remove_node->key != key)
+		return false;
+
+	unlink_node(skiplist, update, remove_node);
+	decrement_node_counts(skiplist, remove_node->height);
+	//Free the allocated memory:
+	free_node(skiplist, remove_node);
+	return true;
+}
+
+void append_node(sl_skip_list* skiplist, sl_node* new_node, unsigned int position, sl_node** last_node, unsigned int* last_position){
+	//Append new_node in every layer it's part of, last_node holds the last node of every layer and its position:
+	for(int i = 0; i <= new_node->height; i++){
+		if(skiplist->flags & SL_INDEXABLE)
+			get_widths(last_node[i])[i] = position - last_position[i];
+		last_node[i]->next_in_layer[i] = new_node;
+		if(skiplist->flags & SL_SUCCESSOR_KEYS)
+			get_successor_keys(skiplist, last_node[i])[i] = new_node->key;
+		last_node[i] = new_node;
+		last_position[i] = position;
+	}
+	increment_node_counts(skiplist, new_node->height);
+}
+
+void finish_appending(sl_skip_list* skiplist, unsigned int node_count, sl_node** last_node, unsigned int* last_position){
+	//The last node of every layer points behind the last appended node:
+	if(skiplist->flags & SL_INDEXABLE){
+		for(int i = 0; i < skiplist->layer_count; i++)
+			get_widths(last_node[i])[i] = node_count - last_position[i];
+	}
+}
 
-			//Case 2.2: new node is located after zero_node and in front of last node
-			else if(new_node->key < next_node->key){
-
-				//Check whether the new node should be inserted in the current layer:
-				if(current_layer <= height){
-					//Insert new node at current layer: Reset the pointer of current node
-					// to point at the new node in the current layer:
-					current_node->next_in_layer[current_layer] = new_node;
-					//Set the pointer of new node to point at the next node in the current layer:
-					new_node->next_in_layer[current_layer] = next_node;
-				}
-				//Drop one layer down:
-				//continue;
+bool write_all(int fd, const unsigned char* bytes, size_t size){
+	//write() may write less than size bytes or get interrupted:
+	while(size > 0){
+		ssize_t written = write(fd, bytes, size);
+		if(written < 0  &&  errno == EINTR)
+			continue;
+		if(written <= 0)
+			return false;
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+
+bool flush_file_buffer(sl_file_buffer* buffer){
+	bool is_written = write_all(buffer->fd, buffer->bytes, buffer->used);
+	buffer->used = 0;
+	return is_written;
+}
+
+bool write_file_bytes(sl_file_buffer* buffer, const void* bytes, size_t size){
+	//Copy into the buffer and write it whenever it's full:
+	const unsigned char* source = bytes;
+	while(size > 0){
+		if(buffer->used == SL_FILE_BUFFER_BYTES  &&  !flush_file_buffer(buffer))
+			return false;
+		size_t copied = SL_FILE_BUFFER_BYTES - buffer->used < size ? SL_FILE_BUFFER_BYTES - buffer->used : size;
+		memcpy(buffer->bytes + buffer->used, source, copied);
+		buffer->used += copied;
+		source += copied;
+		size -= copied;
+	}
+	return true;
+}
+
+bool read_file_bytes(sl_file_buffer* buffer, void* bytes, size_t size){
+	//Copy out of the buffer and refill it whenever it's empty:
+	unsigned char* destination = bytes;
+	while(size > 0){
+		if(buffer->position == buffer->used){
+			ssize_t read_count = read(buffer->fd, buffer->bytes, SL_FILE_BUFFER_BYTES);
+			if(read_count < 0  &&  errno == EINTR)
+				continue;
+			//The file ends in the middle of a record:
+			if(read_count <= 0)
+				return false;
+			buffer->used = read_count;
+			buffer->position = 0;
+		}
+		size_t copied = buffer->used - buffer->position < size ? buffer->used - buffer->position : size;
+		memcpy(destination, buffer->bytes + buffer->position, copied);
+		buffer->position += copied;
+		destination += copied;
+		size -= copied;
+	}
+	return true;
+}
+
+bool reserve_payload(unsigned char** payload, size_t* payload_size, size_t size){
+	//Grow the payload buffer to at least size bytes:
+	if(size <= *payload_size)
+		return true;
+	unsigned char* new_payload = realloc(*payload, size);
+	if(new_payload == NULL)
+		return false;
+	*payload = new_payload;
+	*payload_size = size;
+	return true;
+}
+
+bool save_nodes(sl_skip_list* skiplist, sl_file_buffer* buffer, sl_serialize_function serialize, void* context){
+	unsigned char* payload = NULL;
+	size_t payload_size = 0;
+	bool is_saved = true;
+
+	//One record per node in layer 0 order:
+	for(sl_node* current_node = skiplist->zero_node; current_node != NULL  &&  is_saved; current_node = current_node->next_in_layer[0]){
+		uint32_t key = current_node->key;
+		uint8_t height = current_node->height;
+		is_saved = write_file_bytes(buffer, &key, sizeof(key))  &&  write_file_bytes(buffer, &height, sizeof(height));
+		if(!is_saved  ||  serialize == NULL)
+			continue;
+
+		//serialize() returns the size it needs, call it again with a larger buffer if it didn't fit:
+		size_t size = serialize(current_node->data, payload, payload_size, context);
+		if(size > payload_size){
+			if(!reserve_payload(&payload, &payload_size, size)){
+				is_saved = false;
+				continue;
 			}
-			else if(new_node->key > next_node->key){
-				//Go to the next node in the current layer:
-				current_node = current_node->next_in_layer[current_layer];
+			size = serialize(current_node->data, payload, payload_size, context);
+		}
+		uint32_t stored_size = size;
+		is_saved = size <= UINT32_MAX  &&  write_file_bytes(buffer, &stored_size, sizeof(stored_size))  &&  write_file_bytes(buffer, payload, size);
+	}
+
+	free(payload);
+	return is_saved;
+}
+
+bool load_nodes(sl_skip_list* skiplist, sl_file_buffer* buffer, unsigned int node_count, bool has_payloads, sl_deserialize_function deserialize, void* context){
+	//Last node of every layer and its position, new nodes are appended behind them like in bulk_load():
+	sl_node* last_node[skiplist->layer_count];
+	unsigned int last_position[skiplist->layer_count];
+	unsigned char* payload = NULL;
+	size_t payload_size = 0;
+	unsigned int loaded_count = 0;
+	bool is_loaded = true;
+
+	for(unsigned int i = 0; i < node_count  &&  is_loaded; i++){
+		uint32_t key;
+		uint8_t height;
+		void* data = NULL;
+		if(!read_file_bytes(buffer, &key, sizeof(key))  ||  !read_file_bytes(buffer, &height, sizeof(height))){
+			is_loaded = false;
+			break;
+		}
+
+		if(has_payloads){
+			uint32_t size;
+			is_loaded = read_file_bytes(buffer, &size, sizeof(size))  &&  reserve_payload(&payload, &payload_size, size)  &&
+						read_file_bytes(buffer, payload, size);
+			if(is_loaded  &&  deserialize != NULL)
+				is_loaded = deserialize(payload, size, &data, context);
+			if(!is_loaded)
+				break;
+		}
 
-				//Increment current_layer to stay in current layer because the for-loop decrements current_layer:
-				current_layer++;
+		//Keys need to be increasing and the first node is zero_node with maximum height:
+		if((i > 0  &&  key <= last_node[0]->key)  ||  height >= skiplist->layer_count  ||  (i == 0  &&  height != skiplist->layer_count - 1)){
+			is_loaded = false;
+			break;
+		}
 
-				//continue;
+		sl_node* new_node = create_node(skiplist, key, data, height);
+		//Check whether memory allocation at create_node() worked:
+		if(new_node == NULL){
+			is_loaded = false;
+			break;
+		}
+
+		if(i == 0){
+			skiplist->zero_node = new_node;
+			increment_node_counts(skiplist, height);
+			for(int j = 0; j < skiplist->layer_count; j++){
+				last_node[j] = new_node;
+				last_position[j] = 0;
 			}
-			//Key of new node does already exist in skip list:
-			else /* new_node->key == next_node->key */{
+		}
+		else{
+			append_node(skiplist, new_node, i, last_node, last_position);
+		}
+		loaded_count++;
+	}
+
+	if(loaded_count > 0)
+		finish_appending(skiplist, loaded_count, last_node, last_position);
+	free(payload);
+	return is_loaded;
+}
+
+bool bulk_load(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count, bool balanced){
+	//Only empty skip lists can be loaded:
+	if(skiplist->zero_node != NULL)
+		return false;
+
+	//Check whether keys are sorted, each key can only exist once:
+	for(unsigned int i = 1; i < count; i++){
+		if(keys[i] <= keys[i - 1])
+			return false;
+	}
+
+	if(count == 0)
+		return true;
+
+	unsigned int base = get_growth_threshold(skiplist->probability);
+
+	//Deterministic heights need the height_limit of the final node count up front:
+	if(balanced  &&  (skiplist->flags & SL_DYNAMIC_LAYERS)){
+		unsigned long long nodes_per_layer = base;
+		while(skiplist->height_limit < skiplist->layer_count - 1  &&  nodes_per_layer <= count){
+			skiplist->height_limit++;
+			nodes_per_layer *= base;
+		}
+	}
+
+	//The first key becomes zero_node:
+	sl_node* zero_node = create_node(skiplist, keys[0], data == NULL ? NULL : data[0], skiplist->layer_count - 1);
+	//Check whether memory allocation at create_node() worked:
+	if(zero_node == NULL)
+		return false;
+	skiplist->zero_node = zero_node;
+	increment_node_counts(skiplist, skiplist->layer_count - 1);
+
+	//Last node of every layer and its position, new nodes are appended behind them:
+	sl_node* last_node[skiplist->layer_count];
+	unsigned int last_position[skiplist->layer_count];
+	for(int i = 0; i < skiplist->layer_count; i++){
+		last_node[i] = zero_node;
+		last_position[i] = 0;
+	}
 
-				//Remove the node with this key because we could have changed some pointers 
-				// before we knew that we will "overwrite" this node:
-				if(!sl_remove_node(skiplist, key))
-					return false;
+	unsigned int loaded_count = 1;
+	bool is_loaded = true;
 
-				//Free new_node after calling sl_remove_node() otherwise the skip list wouldn't be connected correctly:
-				free(new_node);
+	for(unsigned int i = 1; i < count; i++){
+		unsigned int height;
 
-				if(!sl_insert_node_static(skiplist, key, data, height))
-					return false;
+		if(balanced){
+			//Every base-th node reaches layer 1, every base^2-th node layer 2 and so on:
+			height = 0;
+			for(unsigned int position = i; position % base == 0  &&  height < skiplist->height_limit; position /= base)
+				height++;
+		}
+		else{
+			height = get_random_height(&skiplist->random_state, skiplist->probability, skiplist->height_limit);
+		}
+
+		sl_node* new_node = create_node(skiplist, keys[i], data == NULL ? NULL : data[i], height);
+		//Check whether memory allocation at create_node() worked, the nodes in front stay loaded:
+		if(new_node == NULL){
+			is_loaded = false;
+			break;
+		}
+
+		append_node(skiplist, new_node, i, last_node, last_position);
+		loaded_count++;
+	}
+
+	finish_appending(skiplist, loaded_count, last_node, last_position);
+	return is_loaded;
+}
+
+void reset_path(sl_skip_list* skiplist, sl_node** path){
+	//Without a previous search every path starts at zero_node:
+	for(int i = 0; i < skiplist->layer_count; i++)
+		path[i] = skiplist->zero_node;
+}
+
+void reset_finger(sl_finger* finger){
+	reset_path(finger->skiplist, finger->path);
+	finger->version = finger->skiplist->version;
+}
+
+/*****************************************************************/
+/************************ Public Functions ***********************/
+/*****************************************************************/
 
-				//Decrement node counts because sl_insert_node_static did increment it:
-				decrement_node_counts(skiplist, height);
+bool sl_insert_node_static(sl_skip_list* skiplist, unsigned int key, void* data, unsigned int height){
+	//Check whether parameter height is valid:
+	if(height > skiplist->layer_count - 1)
+		return false;
+	SL_COUNT_OPERATIONS(skiplist, insertions, 1);
 
-				return true;
-			}
-			
-		}
-		//new_node was inserted successfully -> increment node_counts of the skip list
-		increment_node_counts(skiplist, height);
+	//Case 1: empty skip list, insert the first node with maximum height
+	if(skiplist->zero_node == NULL){
+		sl_node* new_node = create_node(skiplist, key, data, skiplist->layer_count - 1);
+		//Check whether memory allocation at create_node() worked:
+		if(new_node == NULL)
+			return false;
+		skiplist->zero_node = new_node;
+		increment_node_counts(skiplist, skiplist->layer_count - 1);
 	}
+	//Case 2: new node is located behind the zero_node
+	else if(key > skiplist->zero_node->key){
+		//Last node in front of the new node for every layer:
+		sl_node* update[skiplist->layer_count];
+		sl_node* next_node = find_predecessors(skiplist, key, update);
 
-	//Case 3: new_node is located at zero_node
-	else if(new_node->key == skiplist->zero_node->key){
-		//Overwrite the data pointer of zero_node:
-		skiplist->zero_node->data = new_node->data;
-		//Free new_node because it's dispensable:
-		free(new_node);
+		return insert_behind_zero_node(skiplist, update, next_node, key, data, height);
 	}
 
-	//Case 4: new_node is located before zero_node
-	else /* new_node->key < skiplist->zero_node->key */{
-		//Store key and data pointer of zero_node to insert them later as node:
-		int temp_key = skiplist->zero_node->key;
-		void* temp_data = skiplist->zero_node->data;
-
-		//new_node gets set as zero_node:
-		skiplist->zero_node->key = new_node->key;
-		skiplist->zero_node->data = new_node->data;
+	//Case 3: new node is located at zero_node
+	else if(key == skiplist->zero_node->key){
+		//Just overwrite the data pointer of zero_node:
+		skiplist->zero_node->data = data;
+	}
 
-		//Insert the old zero_node with the height that was calculated on beginning of this function:
-		if(!sl_insert_node_static(skiplist, temp_key, temp_data, height))
+	//Case 4: new node is located in front of zero_node
+	else /*key < skiplist->zero_node->key*/{
+		//Allocate the node for key and data of zero_node first, a failed allocation leaves the skip list unchanged:
+		sl_node* new_node = create_node(skiplist, skiplist->zero_node->key, skiplist->zero_node->data, height);
+		if(new_node == NULL)
 			return false;
 
-		//Free new_node because it's dispensable:
-		free(new_node);
+		//New node gets set as zero_node:
+		skiplist->zero_node->key = key;
+		skiplist->zero_node->data = data;
 
-		//increment_node_counts() isn't necessary because sl_insert_node_static() does already increment:
+		//The old key of zero_node is located directly behind it, so zero_node is its predecessor in every layer:
+		sl_node* update[skiplist->layer_count];
+		for(int i = 0; i < skiplist->layer_count; i++)
+			update[i] = skiplist->zero_node;
+		link_node(skiplist, update, new_node);
+		increment_node_counts(skiplist, height);
 	}
 	return true;
 }
 
+bool sl_insert_node(sl_skip_list* skiplist, unsigned int key, void* data){
+	//Generate a random height between 0 and (excluded) maximum height + 1 before allocating the node:
+	return sl_insert_node_static(skiplist, key, data, get_random_height(&skiplist->random_state, skiplist->probability, skiplist->height_limit));
+}
+
+sl_node* sl_upsert(sl_skip_list* skiplist, unsigned int key, void* data){
+	return upsert(skiplist, key, data, true, NULL);
+}
+
+sl_node* sl_get_or_insert(sl_skip_list* skiplist, unsigned int key, void* data, bool* is_inserted){
+	return upsert(skiplist, key, data, false, is_inserted);
+}
+
 sl_node* sl_get_node(sl_skip_list* skiplist, unsigned int key){
+	SL_COUNT_OPERATIONS(skiplist, searches, 1);
+
 	//Check whether skip list is empty or key is located in front of zero_node:
 	if(skiplist->zero_node == NULL  ||  key < skiplist->zero_node->key){
 		return NULL;
 	}
 	//Search for the wanted node:
 	else{
-		//Node pointer that points to the current node in the current layer:
-		sl_node* current_node = skiplist->zero_node;
-
-		//Search layer-wise, start at highest layer:
-		for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
-			//Check whether wanted node was found:
-			if(key == current_node->key){
-				return current_node;
-			}
-			//Check whether wanted node isn't located in current layer
-			else if(current_node->next_in_layer[current_layer] == NULL ||
-					current_node->next_in_layer[current_layer]->key > key){
-				//Drop one layer down:
-				//continue;
-			}
-			else /*(key >= current_node->next_in_layer[current_layer]->key)*/{
-				//Go to the next node in the current layer:
-				current_node = current_node->next_in_layer[current_layer];
-				//Increment current_layer to stay in current layer because the for-loop decrements current_layer:
-				current_layer++;
-				//continue;
-			}	
-		}
-		return NULL;
+		sl_search_counts counts = { 0, 0 };
+		sl_node* node = find_node(skiplist, key, &counts);
+		SL_COUNT(record_search(skiplist, &counts));
+		return node;
 	}
 }
 
@@ -375,8 +1220,8 @@ sl_node* sl_get_last_node(sl_skip_list* skiplist){
 	//Node pointer that points to the current node in the current layer:
 	sl_node* current_node = skiplist->zero_node;
 
-	//Search layer-wise, start at highest layer:
-	for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
+	//Search layer-wise, start at highest non-empty layer:
+	for(int current_layer = skiplist->top_layer; current_layer >= 0; current_layer--){
 		if(current_node->next_in_layer[current_layer] == NULL){
 			//Drop down one layer:
 			//continue;
@@ -393,11 +1238,7 @@ sl_node* sl_get_last_node(sl_skip_list* skiplist){
 }
 
 bool sl_remove_node(sl_skip_list* skiplist, unsigned int key){
-	//When this function found the node that is going to be removed than it's necessary
-	//to store it in remove_node once to free its allocated memory later.
-	//To remember if this was done already we need a bool:
-	bool is_remove_node_selected = false;
-	sl_node* remove_node;
+	SL_COUNT_OPERATIONS(skiplist, removals, 1);
 
 	//Check whether skip list is empty or remove_node is located in front of zero_node:
 	if(skiplist->zero_node == NULL  ||  key < skiplist->zero_node->key)
@@ -405,141 +1246,193 @@ bool sl_remove_node(sl_skip_list* skiplist, unsigned int key){
 
 	//Check whether zero_node must be removed:
 	if(key == skiplist->zero_node->key){
-		//Store the address of the node that's going to be removed to free its memory later:
-		remove_node = skiplist->zero_node;
+		remove_zero_node(skiplist);
+		return true;
+	}
+	//The node that's going to be removed is located behind the zero node:
+	else{
+		//Last node in front of remove_node for every layer:
+		sl_node* update[skiplist->layer_count];
+		sl_node* remove_node = find_predecessors(skiplist, key, update);
+
+		return remove_behind_zero_node(skiplist, update, remove_node, key);
+	}
+}
 
-		//Create new_zero_node:
-		sl_node* new_zero_node = skiplist->zero_node->next_in_layer[0];
+unsigned int sl_remove_node_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key){
+	return sl_remove_node_range_with(skiplist, minimum_key, maximum_key, NULL, NULL);
+}
+
+unsigned int sl_remove_node_range_with(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_visit_function release, void* context){
+	SL_COUNT_OPERATIONS(skiplist, removals, 1);
+
+	//Check validity of parameters and whether skip list is empty:
+	if(minimum_key > maximum_key  ||  skiplist->zero_node == NULL  ||  maximum_key < skiplist->zero_node->key)
+		return 0;
+
+	sl_node* zero_node = skiplist->zero_node;
+	//Last node in front of the range and last node in the range for every layer:
+	sl_node* update[skiplist->layer_count];
+	sl_node* last_node[skiplist->layer_count];
 
-		//If skip list contains only one node:
+	//Case 1: zero_node is in the range
+	if(minimum_key <= zero_node->key){
+		find_last_nodes(skiplist, zero_node, maximum_key, last_node);
+		sl_node* first_node = zero_node->next_in_layer[0];
+		sl_node* new_zero_node = last_node[0]->next_in_layer[0];
+
+		//Report zero_node before its key and data are overwritten:
+		if(release != NULL)
+			release(zero_node, context);
+
+		//Case 1.1: all nodes are in the range, empty the skip list
 		if(new_zero_node == NULL){
-			decrement_node_counts(skiplist, remove_node->height);
-			//empty the skip list:
+			unsigned int removed_count = 1;
+			if(last_node[0] != zero_node)
+				removed_count += remove_run(skiplist, first_node, last_node[0], release, context);
+			decrement_node_counts(skiplist, zero_node->height);
 			skiplist->zero_node = NULL;
-			free(remove_node);
-			return true;
+			free_node(skiplist, zero_node);
+			return removed_count;
 		}
 
-		//Transfer the next_in_layer pointers of zero_node to the next_in_layer pointers of
-		//new_zero_node in the corresponding layers but only those which are higher than height of new_zero_node:
-		for(int i = new_zero_node->height + 1; i < skiplist->layer_count; i++){
-			new_zero_node->next_in_layer[i] = skiplist->zero_node->next_in_layer[i];
+		//Case 1.2: the first node behind the range becomes zero_node, like remove_zero_node() its key and data
+		//are moved into zero_node. Unlink the run and new_zero_node in every layer:
+		if(skiplist->flags & SL_INDEXABLE){
+			//Distances behind new_zero_node stay the same, the other layers lose the removed nodes:
+			unsigned int removed_count = get_distance(zero_node, new_zero_node, 0);
+			for(int i = 0; i < skiplist->layer_count; i++){
+				if(i <= new_zero_node->height)
+					get_widths(zero_node)[i] = get_widths(new_zero_node)[i];
+				else
+					get_widths(zero_node)[i] = get_distance(zero_node, last_node[i], i) + get_widths(last_node[i])[i] - removed_count;
+			}
 		}
+		for(int i = 0; i <= skiplist->top_layer; i++){
+			sl_node* next_node = last_node[i]->next_in_layer[i];
+			zero_node->next_in_layer[i] = next_node == new_zero_node ? new_zero_node->next_in_layer[i] : next_node;
+			if(skiplist->flags & SL_SUCCESSOR_KEYS)
+				get_successor_keys(skiplist, zero_node)[i] = get_successor_keys(skiplist, next_node == new_zero_node ? new_zero_node : last_node[i])[i];
+		}
+		zero_node->key = new_zero_node->key;
+		zero_node->data = new_zero_node->data;
+
+		unsigned int removed_count = 1;
+		if(first_node != new_zero_node)
+			removed_count += remove_run(skiplist, first_node, last_node[0], release, context);
+		//new_zero_node lives on in zero_node and isn't reported:
+		decrement_node_counts(skiplist, new_zero_node->height);
+		free_node(skiplist, new_zero_node);
+		return removed_count;
+	}
 
-		decrement_node_counts(skiplist, remove_node->height);
-
-		//Set new_zero_node as zero_node of the skip list:
-		new_zero_node->height = skiplist->layer_count - 1;
-		skiplist->zero_node = new_zero_node;
-		free(remove_node);
-		return true;
+	//Case 2: the range is located behind zero_node
+	sl_node* first_node = find_predecessors(skiplist, minimum_key, update);
+	if(first_node == NULL  ||  first_node->key > maximum_key)
+		return 0;
+
+	//Layers above top_layer only contain zero_node:
+	for(int i = skiplist->top_layer + 1; i < skiplist->layer_count; i++)
+		last_node[i] = zero_node;
+
+	//Continue from the last node in front of the range, the last node in the range of the layer above may be further:
+	for(int i = skiplist->top_layer; i >= 0; i--){
+		sl_node* current_node = update[i];
+		if(i < skiplist->top_layer  &&  last_node[i + 1]->key > current_node->key)
+			current_node = last_node[i + 1];
+		find_last_nodes_in_layer(current_node, i, maximum_key, last_node);
 	}
-	//The node that's going to be removed is located behind the zero node:
-	else{
-		//Node pointer that points to the current node in the current layer:
-		sl_node* current_node = skiplist->zero_node;
-		//Node pointer that points to the next node in the current layer:
-		sl_node* next_node;
 
-		//Search and reset pointers (next_in_layer) layer-wise:
-		for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
-			//Get next node in layer:
-			next_node = current_node->next_in_layer[current_layer];
-			
-			//Check wether current layer is empty behind current_node or key < key of next node:
-			if(next_node == NULL || key < next_node->key){
-				//Check whether the current layer == 0
-				if(current_layer == 0){
-					//Stop removing because the key isn't in this skip list:
-					return false;
-				}
-				//Drop down one layer:
-				//continue;
-			}
-			else if(key > next_node->key){
-				//Go to the next node in the current layer:
-				current_node = current_node->next_in_layer[current_layer];
-				//Increment current_layer to stay in current layer because the for-loop decrements current_layer:
-				current_layer++;
-				//continue;
-			}
-			else /* key == next_node->key */{
-				//Found the pointer (current_node->next_in_layer[current_layer]) that points at the node wich is going to be removed:
-				if(!is_remove_node_selected){
-					//Store the node that's going to be removed to free its memory later:
-					remove_node = current_node->next_in_layer[current_layer];
-					is_remove_node_selected = true;
-				}
-
-				//current_node points now at the node in current layer that comes after the node that is going to be removed:
-				current_node->next_in_layer[current_layer] = next_node->next_in_layer[current_layer];
-
-				if(current_layer == 0){
-					decrement_node_counts(skiplist, remove_node->height);
-					//Free the allocated memory:
-					free(remove_node);
-					break;
-				}
-				//Drop down one layer:
-				//continue;
-			}	
+	//The pointers in front of the run jump over the removed nodes:
+	if(skiplist->flags & SL_INDEXABLE){
+		unsigned int removed_count = get_distance(update[0], last_node[0], 0);
+		for(int i = 0; i < skiplist->layer_count; i++){
+			if(update[i] != last_node[i])
+				get_widths(update[i])[i] = get_distance(update[i], last_node[i], i) + get_widths(last_node[i])[i] - removed_count;
+			else
+				get_widths(update[i])[i] -= removed_count;
 		}
-		//Node was removed:
-		return true;
 	}
-}
-
-bool sl_remove_node_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key){
-	//Check validity of parameters:
-	if(minimum_key >= maximum_key)
-		return false;
-
-	//Check whether skip list is empty:
-	else if(skiplist->zero_node == NULL)
-		return false;
 
-	//Remove nodes in given range:
-	else{
-		sl_node* current_node = sl_get_node(skiplist, minimum_key);
-
-		//If no node with minimum_key does exist in skip list search for next greater key:
-		while(current_node == NULL)
-			current_node = sl_get_node(skiplist, minimum_key++);
-
-		//Remove nodes in given range
-		while(current_node != NULL  &&  current_node->key <= maximum_key){
-			//Check sl_remove_node() because it returns false if no node was deleted.
-			//Because it's garanteed (here) that everytime we call sl_remove_node() it should return true,
-			//it's necessary to return false when one single call of sl_remove_node() returns false:
-			if(!sl_remove_node(skiplist, current_node->key))
-				return false;
-			//Get next node:
-			current_node = current_node->next_in_layer[0];
+	//Unlink the whole run in every layer at once:
+	for(int i = 0; i <= skiplist->top_layer; i++){
+		if(update[i] != last_node[i]){
+			update[i]->next_in_layer[i] = last_node[i]->next_in_layer[i];
+			if(skiplist->flags & SL_SUCCESSOR_KEYS)
+				get_successor_keys(skiplist, update[i])[i] = get_successor_keys(skiplist, last_node[i])[i];
 		}
-
-		//All nodes were removed successfully:
-		return true;
 	}
+
+	return remove_run(skiplist, first_node, last_node[0], release, context);
 }
 
-sl_skip_list* sl_create_skip_list(unsigned int layers){
+sl_skip_list* sl_create_custom_skip_list(unsigned int layers, unsigned int flags, const sl_allocator* allocator){
 	//Check parameter:
 	if(layers == 0)
 		return NULL;
 
-	//Allocate memory, set all bytes to 0:
-	sl_skip_list* skiplist = calloc(1, sizeof(sl_skip_list) + sizeof(int) * layers);
-	//In case calloc() returned NULL, we need to avoid null references:
+	//Use malloc() and free() if there are no allocator hooks:
+	sl_allocator used_allocator = { .allocate = default_allocate, .release = default_release, .context = NULL };
+	if(allocator != NULL)
+		used_allocator = *allocator;
+
+	size_t skiplist_size = sizeof(sl_skip_list) + sizeof(int) * layers;
+	sl_skip_list* skiplist = used_allocator.allocate(skiplist_size, used_allocator.context);
+	//In case the allocator returned NULL, we need to avoid null references:
 	if(skiplist == NULL)
 		return skiplist;
+	//Set all bytes to 0:
+	memset(skiplist, 0, skiplist_size);
+
 	//Set layer_count:
 	skiplist->layer_count = layers;
+	skiplist->flags = flags;
+	skiplist->allocator = used_allocator;
+	skiplist->allocated_bytes = skiplist_size;
 	//Shouldn't rely on the machine interpreting that 0ed bits mean NULL:
 	skiplist->zero_node = NULL;
+	skiplist->slab_classes = NULL;
+
+	//A dynamic skip list starts with one layer and grows up to layers:
+	skiplist->height_limit = (flags & SL_DYNAMIC_LAYERS) ? 0 : layers - 1;
+	skiplist->top_layer = 0;
+
+	//Every skip list gets its own seed, use sl_set_seed() for reproducible heights:
+	skiplist->probability = SL_P_HALF;
+	sl_set_seed(skiplist, sl_random_default_seed(skiplist));
+
+	//Create one size class per height:
+	if(flags & SL_USE_SLABS){
+		size_t slab_classes_size = sizeof(sl_slab_class) * layers;
+		skiplist->slab_classes = used_allocator.allocate(slab_classes_size, used_allocator.context);
+		if(skiplist->slab_classes == NULL){
+			used_allocator.release(skiplist, used_allocator.context);
+			return NULL;
+		}
+		skiplist->allocated_bytes += slab_classes_size;
+
+		for(int i = 0; i < layers; i++){
+			skiplist->slab_classes[i].first_slab = NULL;
+			skiplist->slab_classes[i].next_slab_bytes = SLAB_MINIMUM_BYTES;
+		}
+		reset_slabs(skiplist);
+	}
 
 	return skiplist;
 }
 
+sl_skip_list* sl_create_skip_list(unsigned int layers){
+	return sl_create_custom_skip_list(layers, 0, NULL);
+}
+
+void sl_set_seed(sl_skip_list* skiplist, uint64_t seed){
+	skiplist->random_state = sl_random_state(seed);
+}
+
+void sl_set_probability(sl_skip_list* skiplist, sl_probability probability){
+	skiplist->probability = probability;
+}
+
 bool sl_display_skip_list(sl_skip_list* skiplist){
 	//Check whether the skip list is empty:
 	if(skiplist->zero_node == NULL)
@@ -637,18 +1530,474 @@ bool sl_display_skip_list(sl_skip_list* skiplist){
 	return true;
 }	
 
-void sl_remove_skip_list(sl_skip_list* skiplist){
-	sl_node* current_node = skiplist->zero_node;
-	sl_node* next_node;
+void sl_clear_skip_list(sl_skip_list* skiplist){
+	//Nodes of slabs don't need to be freed one by one:
+	if(skiplist->slab_classes != NULL){
+		reset_slabs(skiplist);
+	}
+	else{
+		sl_node* current_node = skiplist->zero_node;
+		sl_node* next_node;
 
-	//Remove all nodes:
-	while(current_node != NULL){
-		next_node = current_node->next_in_layer[0];
-		free(current_node);
-		current_node = next_node;
+		//Remove all nodes:
+		while(current_node != NULL){
+			next_node = current_node->next_in_layer[0];
+			free_node(skiplist, current_node);
+			current_node = next_node;
+		}
+	}
+
+	skiplist->zero_node = NULL;
+	for(int i = 0; i < skiplist->layer_count; i++)
+		skiplist->node_count_in_layer[i] = 0;
+	skiplist->top_layer = 0;
+	if(skiplist->flags & SL_DYNAMIC_LAYERS)
+		skiplist->height_limit = 0;
+	skiplist->version++;
+}
+
+void sl_remove_skip_list(sl_skip_list* skiplist){
+	//Remove all nodes, a slab pool releases whole slabs instead:
+	if(skiplist->slab_classes != NULL){
+		release_slabs(skiplist);
+		skiplist->allocator.release(skiplist->slab_classes, skiplist->allocator.context);
+	}
+	else{
+		sl_clear_skip_list(skiplist);
 	}
 
 	//Free allocated memory of the skip list:
-	free(skiplist);
+	skiplist->allocator.release(skiplist, skiplist->allocator.context);
 	return;
-}
\ No newline at end of file
+}
+
+size_t sl_get_memory_usage(sl_skip_list* skiplist){
+	return skiplist->allocated_bytes;
+}
+
+void sl_get_stats(sl_skip_list* skiplist, sl_stats* stats){
+	memset(stats, 0, sizeof(sl_stats));
+#ifdef SL_STATISTICS
+	stats->is_counting = true;
+	//Read every counter on its own, searches of other threads may add to them meanwhile:
+	sl_counters* counters = &skiplist->counters;
+	stats->counters.insertions = __atomic_load_n(&counters->insertions, __ATOMIC_RELAXED);
+	stats->counters.searches = __atomic_load_n(&counters->searches, __ATOMIC_RELAXED);
+	stats->counters.removals = __atomic_load_n(&counters->removals, __ATOMIC_RELAXED);
+	stats->counters.comparisons = __atomic_load_n(&counters->comparisons, __ATOMIC_RELAXED);
+	stats->counters.visited_nodes = __atomic_load_n(&counters->visited_nodes, __ATOMIC_RELAXED);
+	for(int i = 0; i < SL_SEARCH_LENGTH_BUCKETS; i++)
+		stats->counters.search_lengths[i] = __atomic_load_n(&counters->search_lengths[i], __ATOMIC_RELAXED);
+#endif /*SL_STATISTICS*/
+
+	stats->layer_count = skiplist->layer_count;
+	//top_layer is the highest layer with a node behind zero_node, the layers above it are unused:
+	stats->unused_layers = skiplist->layer_count - 1 - skiplist->top_layer;
+	stats->allocated_bytes = skiplist->allocated_bytes;
+	stats->node_count_in_layer = skiplist->node_count_in_layer;
+}
+
+void sl_reset_stats(sl_skip_list* skiplist){
+#ifdef SL_STATISTICS
+	memset(&skiplist->counters, 0, sizeof(sl_counters));
+#endif /*SL_STATISTICS*/
+}
+
+sl_finger* sl_create_finger(sl_skip_list* skiplist){
+	sl_finger* finger = skiplist->allocator.allocate(sizeof(sl_finger) + sizeof(sl_node*) * skiplist->layer_count, skiplist->allocator.context);
+	//In case the allocator returned NULL, we need to avoid null references:
+	if(finger == NULL)
+		return finger;
+
+	finger->skiplist = skiplist;
+	reset_finger(finger);
+	return finger;
+}
+
+void sl_remove_finger(sl_finger* finger){
+	finger->skiplist->allocator.release(finger, finger->skiplist->allocator.context);
+}
+
+sl_node* sl_get_node_from(sl_finger* finger, unsigned int key){
+	sl_skip_list* skiplist = finger->skiplist;
+
+	//Check whether skip list is empty or key is located at or in front of zero_node:
+	if(skiplist->zero_node == NULL  ||  key <= skiplist->zero_node->key)
+		return sl_get_node(skiplist, key);
+
+	//Forget the path if the skip list was changed without this finger:
+	if(finger->version != skiplist->version)
+		reset_finger(finger);
+
+	SL_COUNT_OPERATIONS(skiplist, searches, 1);
+	sl_node* node = find_predecessors_from(skiplist, key, finger->path);
+	if(node == NULL  ||  node->key != key)
+		return NULL;
+	return node;
+}
+
+bool sl_insert_from(sl_finger* finger, unsigned int key, void* data){
+	sl_skip_list* skiplist = finger->skiplist;
+
+	//Insertions at or in front of zero_node don't need a search:
+	if(skiplist->zero_node == NULL  ||  key <= skiplist->zero_node->key)
+		return sl_insert_node(skiplist, key, data);
+
+	//Forget the path if the skip list was changed without this finger:
+	if(finger->version != skiplist->version)
+		reset_finger(finger);
+
+	SL_COUNT_OPERATIONS(skiplist, insertions, 1);
+	unsigned int height = get_random_height(&skiplist->random_state, skiplist->probability, skiplist->height_limit);
+	sl_node* next_node = find_predecessors_from(skiplist, key, finger->path);
+
+	if(!insert_behind_zero_node(skiplist, finger->path, next_node, key, data, height))
+		return false;
+
+	//The path is still in front of key, keep it for the next call:
+	finger->version = skiplist->version;
+	return true;
+}
+
+bool sl_remove_from(sl_finger* finger, unsigned int key){
+	sl_skip_list* skiplist = finger->skiplist;
+
+	//Removing zero_node doesn't need a search:
+	if(skiplist->zero_node == NULL  ||  key <= skiplist->zero_node->key)
+		return sl_remove_node(skiplist, key);
+
+	//Forget the path if the skip list was changed without this finger:
+	if(finger->version != skiplist->version)
+		reset_finger(finger);
+
+	SL_COUNT_OPERATIONS(skiplist, removals, 1);
+	sl_node* remove_node = find_predecessors_from(skiplist, key, finger->path);
+
+	if(!remove_behind_zero_node(skiplist, finger->path, remove_node, key))
+		return false;
+
+	//The path is still in front of key, keep it for the next call:
+	finger->version = skiplist->version;
+	return true;
+}
+
+bool sl_bulk_load(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count){
+	return bulk_load(skiplist, keys, data, count, false);
+}
+
+bool sl_bulk_load_balanced(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count){
+	return bulk_load(skiplist, keys, data, count, true);
+}
+
+unsigned int sl_insert_node_batch(sl_skip_list* skiplist, const unsigned int* keys, void* const* data, unsigned int count, bool* results){
+	//Last node in front of the previous key for every layer:
+	sl_node* path[skiplist->layer_count];
+	bool is_path_valid = false;
+	unsigned int inserted_count = 0;
+
+	for(unsigned int i = 0; i < count; i++){
+		void* node_data = data == NULL ? NULL : data[i];
+		bool result;
+
+		//Insertions at or in front of zero_node change zero_node, the path has to start at zero_node again:
+		if(skiplist->zero_node == NULL  ||  keys[i] <= skiplist->zero_node->key){
+			result = sl_insert_node(skiplist, keys[i], node_data);
+			is_path_valid = false;
+		}
+		else{
+			if(!is_path_valid){
+				reset_path(skiplist, path);
+				is_path_valid = true;
+			}
+
+			//Walk forward from the path of the previous key:
+			SL_COUNT_OPERATIONS(skiplist, insertions, 1);
+			unsigned int height = get_random_height(&skiplist->random_state, skiplist->probability, skiplist->height_limit);
+			sl_node* next_node = find_predecessors_from(skiplist, keys[i], path);
+			result = insert_behind_zero_node(skiplist, path, next_node, keys[i], node_data, height);
+		}
+
+		if(results != NULL)
+			results[i] = result;
+		if(result)
+			inserted_count++;
+	}
+	return inserted_count;
+}
+
+unsigned int sl_get_node_batch(sl_skip_list* skiplist, const unsigned int* keys, unsigned int count, sl_node** nodes){
+	//Last node in front of the previous key for every layer:
+	sl_node* path[skiplist->layer_count];
+	unsigned int found_count = 0;
+
+	reset_path(skiplist, path);
+
+	for(unsigned int i = 0; i < count; i++){
+		//Check whether skip list is empty or key is located at or in front of zero_node:
+		if(skiplist->zero_node == NULL  ||  keys[i] <= skiplist->zero_node->key){
+			nodes[i] = sl_get_node(skiplist, keys[i]);
+		}
+		else{
+			//Walk forward from the path of the previous key:
+			SL_COUNT_OPERATIONS(skiplist, searches, 1);
+			nodes[i] = find_predecessors_from(skiplist, keys[i], path);
+			if(nodes[i] != NULL  &&  nodes[i]->key != keys[i])
+				nodes[i] = NULL;
+		}
+
+		if(nodes[i] != NULL)
+			found_count++;
+	}
+	return found_count;
+}
+
+unsigned int sl_get_many(sl_skip_list* skiplist, const unsigned int* keys, unsigned int count, sl_node** nodes){
+	sl_search_stream streams[SL_GET_MANY_STREAMS];
+	unsigned int stream_count = 0;
+	unsigned int next_index = 0;
+	unsigned int found_count = 0;
+	SL_COUNT_OPERATIONS(skiplist, searches, count);
+
+	//Check whether skip list is empty:
+	if(skiplist->zero_node == NULL){
+		for(unsigned int i = 0; i < count; i++)
+			nodes[i] = NULL;
+		return 0;
+	}
+
+	//Start the first searches:
+	while(stream_count < SL_GET_MANY_STREAMS  &&  next_index < count){
+		if(start_search_stream(skiplist, keys, next_index, nodes, &streams[stream_count]))
+			stream_count++;
+		else if(nodes[next_index] != NULL)
+			found_count++;
+		next_index++;
+	}
+
+	//Advance every search by one node in turn, a finished search hands its slot to the next key:
+	while(stream_count > 0){
+		for(int i = 0; i < stream_count; i++){
+			if(!step_search_stream(skiplist, keys, nodes, &streams[i]))
+				continue;
+			if(nodes[streams[i].index] != NULL)
+				found_count++;
+
+			bool is_started = false;
+			while(!is_started  &&  next_index < count){
+				is_started = start_search_stream(skiplist, keys, next_index, nodes, &streams[i]);
+				if(!is_started  &&  nodes[next_index] != NULL)
+					found_count++;
+				next_index++;
+			}
+			//No keys left, the last search takes over the slot and gets its turn now:
+			if(!is_started){
+				streams[i] = streams[--stream_count];
+				i--;
+			}
+		}
+	}
+	return found_count;
+}
+
+unsigned int sl_remove_node_batch(sl_skip_list* skiplist, const unsigned int* keys, unsigned int count, bool* results){
+	//Last node in front of the previous key for every layer:
+	sl_node* path[skiplist->layer_count];
+	bool is_path_valid = false;
+	unsigned int removed_count = 0;
+
+	for(unsigned int i = 0; i < count; i++){
+		bool result;
+
+		//Removing zero_node changes zero_node, the path has to start at zero_node again:
+		if(skiplist->zero_node == NULL  ||  keys[i] <= skiplist->zero_node->key){
+			result = sl_remove_node(skiplist, keys[i]);
+			is_path_valid = false;
+		}
+		else{
+			if(!is_path_valid){
+				reset_path(skiplist, path);
+				is_path_valid = true;
+			}
+
+			//Walk forward from the path of the previous key:
+			SL_COUNT_OPERATIONS(skiplist, removals, 1);
+			sl_node* remove_node = find_predecessors_from(skiplist, keys[i], path);
+			result = remove_behind_zero_node(skiplist, path, remove_node, keys[i]);
+		}
+
+		if(results != NULL)
+			results[i] = result;
+		if(result)
+			removed_count++;
+	}
+	return removed_count;
+}
+
+void sl_cursor_init(sl_cursor* cursor, sl_skip_list* skiplist){
+	cursor->skiplist = skiplist;
+	//Start at the first node:
+	cursor->node = skiplist->zero_node;
+}
+
+bool sl_cursor_seek(sl_cursor* cursor, unsigned int key){
+	SL_COUNT_OPERATIONS(cursor->skiplist, searches, 1);
+	cursor->node = find_first_node(cursor->skiplist, key);
+	return cursor->node != NULL;
+}
+
+bool sl_cursor_next(sl_cursor* cursor){
+	//Stay invalid behind the last node:
+	if(cursor->node != NULL)
+		cursor->node = cursor->node->next_in_layer[0];
+	return cursor->node != NULL;
+}
+
+bool sl_cursor_valid(const sl_cursor* cursor){
+	return cursor->node != NULL;
+}
+
+unsigned int sl_cursor_key(const sl_cursor* cursor){
+	return cursor->node->key;
+}
+
+void* sl_cursor_data(const sl_cursor* cursor){
+	return cursor->node->data;
+}
+
+unsigned int sl_scan_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_visit_function visit, void* context){
+	unsigned int visited_count = 0;
+	SL_COUNT_OPERATIONS(skiplist, searches, 1);
+
+	//Visit the nodes in layer 0 from the first node with a key >= minimum_key on:
+	for(sl_node* current_node = find_first_node(skiplist, minimum_key);
+		current_node != NULL  &&  current_node->key <= maximum_key;
+		current_node = current_node->next_in_layer[0]){
+
+		visited_count++;
+		//Stop when visit() asks for it:
+		if(!visit(current_node, context))
+			break;
+	}
+	return visited_count;
+}
+
+unsigned int sl_rank(sl_skip_list* skiplist, unsigned int key){
+	//Check whether skip list is empty or key is located at or in front of zero_node:
+	if(skiplist->zero_node == NULL  ||  key <= skiplist->zero_node->key)
+		return 0;
+
+	//Without widths count the nodes in layer 0:
+	if(!(skiplist->flags & SL_INDEXABLE)){
+		unsigned int rank = 0;
+		for(sl_node* current_node = skiplist->zero_node; current_node != NULL  &&  current_node->key < key; current_node = current_node->next_in_layer[0])
+			rank++;
+		return rank;
+	}
+
+	//Node pointer that points to the current node in the current layer:
+	sl_node* current_node = skiplist->zero_node;
+	//Position of current_node:
+	unsigned int rank = 0;
+
+	//Search layer-wise for the last node in front of key and sum up the widths of the way:
+	for(int current_layer = skiplist->top_layer; current_layer >= 0; current_layer--){
+		while(current_node->next_in_layer[current_layer] != NULL  &&  current_node->next_in_layer[current_layer]->key < key){
+			rank += get_widths(current_node)[current_layer];
+			current_node = current_node->next_in_layer[current_layer];
+		}
+	}
+	//key is located behind current_node:
+	return rank + 1;
+}
+
+sl_node* sl_select(sl_skip_list* skiplist, unsigned int index){
+	//Check whether index is located behind the last node:
+	if(index >= skiplist->node_count_in_layer[0])
+		return NULL;
+
+	//Node pointer that points to the current node in the current layer:
+	sl_node* current_node = skiplist->zero_node;
+
+	//Without widths walk through layer 0:
+	if(!(skiplist->flags & SL_INDEXABLE)){
+		while(index-- > 0)
+			current_node = current_node->next_in_layer[0];
+		return current_node;
+	}
+
+	//Search layer-wise, go forward while the width doesn't jump over index:
+	for(int current_layer = skiplist->top_layer; current_layer >= 0  &&  index > 0; current_layer--){
+		while(current_node->next_in_layer[current_layer] != NULL  &&  get_widths(current_node)[current_layer] <= index){
+			index -= get_widths(current_node)[current_layer];
+			current_node = current_node->next_in_layer[current_layer];
+		}
+	}
+	return current_node;
+}
+
+unsigned int sl_count_range(sl_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key){
+	//Check validity of parameters:
+	if(minimum_key > maximum_key)
+		return 0;
+
+	//Amount of nodes with a key <= maximum_key, maximum_key + 1 would overflow for the highest key:
+	unsigned int end_rank = maximum_key == UINT_MAX ? skiplist->node_count_in_layer[0] : sl_rank(skiplist, maximum_key + 1);
+	return end_rank - sl_rank(skiplist, minimum_key);
+}
+
+bool sl_save(sl_skip_list* skiplist, int fd, sl_serialize_function serialize, void* context){
+	//Heights are stored in one byte:
+	if(skiplist->layer_count > UINT8_MAX + 1)
+		return false;
+
+	sl_file_buffer* buffer = malloc(sizeof(sl_file_buffer));
+	if(buffer == NULL)
+		return false;
+	buffer->fd = fd;
+	buffer->used = 0;
+
+	sl_file_header header;
+	memcpy(header.magic, SL_FILE_MAGIC, sizeof(header.magic));
+	header.layer_count = skiplist->layer_count;
+	header.flags = skiplist->flags;
+	header.probability = skiplist->probability;
+	header.node_count = skiplist->zero_node == NULL ? 0 : skiplist->node_count_in_layer[0];
+	header.has_payloads = serialize != NULL;
+
+	bool is_saved = write_file_bytes(buffer, &header, sizeof(header))  &&  save_nodes(skiplist, buffer, serialize, context)  &&
+					flush_file_buffer(buffer);
+	free(buffer);
+	return is_saved;
+}
+
+sl_skip_list* sl_load(int fd, sl_deserialize_function deserialize, void* context){
+	sl_file_buffer* buffer = malloc(sizeof(sl_file_buffer));
+	if(buffer == NULL)
+		return NULL;
+	buffer->fd = fd;
+	buffer->used = 0;
+	buffer->position = 0;
+
+	//Check whether fd is a file of sl_save():
+	sl_file_header header;
+	if(!read_file_bytes(buffer, &header, sizeof(header))  ||  memcmp(header.magic, SL_FILE_MAGIC, sizeof(header.magic)) != 0  ||
+	   header.layer_count == 0  ||  header.layer_count > UINT8_MAX + 1  ||  header.probability > SL_P_INV_E){
+		free(buffer);
+		return NULL;
+	}
+
+	sl_skip_list* skiplist = sl_create_custom_skip_list(header.layer_count, header.flags, NULL);
+	if(skiplist == NULL){
+		free(buffer);
+		return NULL;
+	}
+	skiplist->probability = header.probability;
+
+	//A broken file removes the nodes loaded so far, their deserialized data isn't released:
+	if(!load_nodes(skiplist, buffer, header.node_count, header.has_payloads, deserialize, context)){
+		sl_remove_skip_list(skiplist);
+		skiplist = NULL;
+	}
+	free(buffer);
+	return skiplist;
+}
@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#if defined(__AVX2__)  ||  defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "skiplist_blocked.h"
+#include "skiplist_random.h"
+
+//Keys of one block fill one cache line, the vector search below is written for exactly 16 keys
+#define BLOCK_CAPACITY 16
+#define BLOCK_ALIGNMENT 64
+//A block with less keys is merged with its successor if both fit into one block
+#define BLOCK_MERGE_THRESHOLD (BLOCK_CAPACITY / 4)
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//block, next_in_layer holds height + 1 pointers and the layers are sorted by keys[0]
+typedef struct _sl_block{
+	//sorted keys, unused entries are UINT_MAX so the vector compares can check the whole line
+	_Alignas(BLOCK_ALIGNMENT) unsigned int keys[BLOCK_CAPACITY];
+	void* data[BLOCK_CAPACITY];
+	unsigned int count;
+	unsigned int height;
+	struct _sl_block* next_in_layer[];
+}sl_block;
+
+struct _sl_blocked_skip_list{
+	//empty block in front of all blocks, its keys are never compared
+	sl_block* head;
+	unsigned int layer_count;
+	unsigned int node_count;
+	size_t allocated_bytes;
+	uint64_t random_state;
+};
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+//Returns the amount of keys in block that are smaller than key, that's the index of key or where it belongs
+unsigned int get_lower_bound(const sl_block* block, unsigned int key){
+#if defined(__AVX2__)
+	//Compares are signed, flipping the highest bit keeps the order of unsigned keys:
+	__m256i bias = _mm256_set1_epi32(INT_MIN);
+	__m256i search_key = _mm256_xor_si256(_mm256_set1_epi32((int)key), bias);
+	__m256i low_keys = _mm256_xor_si256(_mm256_load_si256((const __m256i*)block->keys), bias);
+	__m256i high_keys = _mm256_xor_si256(_mm256_load_si256((const __m256i*)(block->keys + 8)), bias);
+	unsigned int low_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(search_key, low_keys)));
+	unsigned int high_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(search_key, high_keys)));
+	return __builtin_popcount(low_mask | (high_mask << 8));
+#elif defined(__SSE2__)
+	//Compares are signed, flipping the highest bit keeps the order of unsigned keys:
+	__m128i bias = _mm_set1_epi32(INT_MIN);
+	__m128i search_key = _mm_xor_si128(_mm_set1_epi32((int)key), bias);
+	unsigned int mask = 0;
+	for(int i = 0; i < BLOCK_CAPACITY / 4; i++){
+		__m128i keys = _mm_xor_si128(_mm_load_si128((const __m128i*)(block->keys + 4 * i)), bias);
+		mask |= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(search_key, keys))) << (4 * i);
+	}
+	return __builtin_popcount(mask);
+#else
+	unsigned int index = 0;
+	while(index < block->count  &&  block->keys[index] < key)
+		index++;
+	return index;
+#endif
+}
+
+unsigned int get_block_height(sl_blocked_skip_list* skiplist){
+	return sl_random_height(&skiplist->random_state, skiplist->layer_count - 1);
+}
+
+size_t get_block_size(unsigned int height){
+	size_t size = sizeof(sl_block) + (height + 1) * sizeof(sl_block*);
+	return (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+sl_block* create_block(sl_blocked_skip_list* skiplist, unsigned int height){
+	sl_block* block = aligned_alloc(BLOCK_ALIGNMENT, get_block_size(height));
+	if(block == NULL)
+		return NULL;
+	for(int i = 0; i < BLOCK_CAPACITY; i++)
+		block->keys[i] = UINT_MAX;
+	block->count = 0;
+	block->height = height;
+	for(unsigned int i = 0; i <= height; i++)
+		block->next_in_layer[i] = NULL;
+	skiplist->allocated_bytes += get_block_size(height);
+	return block;
+}
+
+void free_block(sl_blocked_skip_list* skiplist, sl_block* block){
+	skiplist->allocated_bytes -= get_block_size(block->height);
+	free(block);
+}
+
+//Searches the last block whose lowest key is <= key in every layer, returns the block of layer 0 (head if none)
+sl_block* find_blocks(sl_blocked_skip_list* skiplist, unsigned int key, sl_block** update){
+	sl_block* current_block = skiplist->head;
+	for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
+		while(current_block->next_in_layer[current_layer] != NULL  &&  current_block->next_in_layer[current_layer]->keys[0] <= key)
+			current_block = current_block->next_in_layer[current_layer];
+		if(update != NULL)
+			update[current_layer] = current_block;
+	}
+	return current_block;
+}
+
+void link_block(sl_block** update, sl_block* block){
+	for(unsigned int i = 0; i <= block->height; i++){
+		block->next_in_layer[i] = update[i]->next_in_layer[i];
+		update[i]->next_in_layer[i] = block;
+	}
+}
+
+void unlink_block(sl_block** update, sl_block* block){
+	for(unsigned int i = 0; i <= block->height; i++)
+		update[i]->next_in_layer[i] = block->next_in_layer[i];
+}
+
+void insert_into_block(sl_block* block, unsigned int index, unsigned int key, void* data){
+	memmove(block->keys + index + 1, block->keys + index, (block->count - index) * sizeof(unsigned int));
+	memmove(block->data + index + 1, block->data + index, (block->count - index) * sizeof(void*));
+	block->keys[index] = key;
+	block->data[index] = data;
+	block->count++;
+}
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+sl_blocked_skip_list* sl_create_blocked_skip_list(unsigned int amount_of_layers){
+	if(amount_of_layers == 0)
+		return NULL;
+	sl_blocked_skip_list* skiplist = malloc(sizeof(sl_blocked_skip_list));
+	if(skiplist == NULL)
+		return NULL;
+	skiplist->layer_count = amount_of_layers;
+	skiplist->node_count = 0;
+	skiplist->allocated_bytes = sizeof(sl_blocked_skip_list);
+	//Every skip list gets its own seed, use sl_blocked_set_seed() for reproducible heights:
+	sl_blocked_set_seed(skiplist, sl_random_default_seed(skiplist));
+	skiplist->head = create_block(skiplist, amount_of_layers - 1);
+	if(skiplist->head == NULL){
+		free(skiplist);
+		return NULL;
+	}
+	return skiplist;
+}
+
+void sl_remove_blocked_skip_list(sl_blocked_skip_list* skiplist){
+	sl_block* current_block = skiplist->head;
+	while(current_block != NULL){
+		sl_block* next_block = current_block->next_in_layer[0];
+		free(current_block);
+		current_block = next_block;
+	}
+	free(skiplist);
+}
+
+bool sl_blocked_insert_node(sl_blocked_skip_list* skiplist, unsigned int key, void* data){
+	sl_block* update[skiplist->layer_count];
+	sl_block* block = find_blocks(skiplist, key, update);
+
+	//Keys in front of all blocks go into the first block:
+	if(block == skiplist->head){
+		block = skiplist->head->next_in_layer[0];
+		//The first key gets the first block:
+		if(block == NULL){
+			block = create_block(skiplist, get_block_height(skiplist));
+			if(block == NULL)
+				return false;
+			link_block(update, block);
+		}
+	}
+	//block is the predecessor of blocks that are split off from it:
+	for(unsigned int i = 0; i <= block->height; i++)
+		update[i] = block;
+
+	unsigned int index = get_lower_bound(block, key);
+	if(index < block->count  &&  block->keys[index] == key){
+		block->data[index] = data;
+		return true;
+	}
+
+	//Split a full block in two halves:
+	if(block->count == BLOCK_CAPACITY){
+		sl_block* new_block = create_block(skiplist, get_block_height(skiplist));
+		if(new_block == NULL)
+			return false;
+		unsigned int half = BLOCK_CAPACITY / 2;
+		memcpy(new_block->keys, block->keys + half, half * sizeof(unsigned int));
+		memcpy(new_block->data, block->data + half, half * sizeof(void*));
+		new_block->count = half;
+		for(unsigned int i = half; i < BLOCK_CAPACITY; i++)
+			block->keys[i] = UINT_MAX;
+		block->count = half;
+		link_block(update, new_block);
+
+		if(index > half){
+			block = new_block;
+			index -= half;
+		}
+	}
+	insert_into_block(block, index, key, data);
+	skiplist->node_count++;
+	return true;
+}
+
+bool sl_blocked_get_data(sl_blocked_skip_list* skiplist, unsigned int key, void** data){
+	sl_block* block = find_blocks(skiplist, key, NULL);
+	if(block == skiplist->head)
+		return false;
+
+	unsigned int index = get_lower_bound(block, key);
+	if(index == block->count  ||  block->keys[index] != key)
+		return false;
+	if(data != NULL)
+		*data = block->data[index];
+	return true;
+}
+
+bool sl_blocked_remove_node(sl_blocked_skip_list* skiplist, unsigned int key){
+	sl_block* update[skiplist->layer_count];
+	sl_block* block = find_blocks(skiplist, key, update);
+	if(block == skiplist->head)
+		return false;
+
+	unsigned int index = get_lower_bound(block, key);
+	if(index == block->count  ||  block->keys[index] != key)
+		return false;
+	unsigned int lowest_key = block->keys[0];
+
+	//Close the gap, the free entry gets UINT_MAX again:
+	memmove(block->keys + index, block->keys + index + 1, (block->count - index - 1) * sizeof(unsigned int));
+	memmove(block->data + index, block->data + index + 1, (block->count - index - 1) * sizeof(void*));
+	block->count--;
+	block->keys[block->count] = UINT_MAX;
+	skiplist->node_count--;
+
+	//Move the successor into a sparse block:
+	sl_block* next_block = block->next_in_layer[0];
+	if(block->count < BLOCK_MERGE_THRESHOLD  &&  next_block != NULL  &&  block->count + next_block->count <= BLOCK_CAPACITY){
+		memcpy(block->keys + block->count, next_block->keys, next_block->count * sizeof(unsigned int));
+		memcpy(block->data + block->count, next_block->data, next_block->count * sizeof(void*));
+		block->count += next_block->count;
+		//block is the predecessor of next_block up to its own height:
+		for(unsigned int i = 0; i <= block->height; i++)
+			update[i] = block;
+		unlink_block(update, next_block);
+		free_block(skiplist, next_block);
+	}
+	//The last block is removed as soon as it's empty:
+	else if(block->count == 0){
+		if(lowest_key == 0){
+			for(unsigned int i = 0; i < skiplist->layer_count; i++)
+				update[i] = skiplist->head;
+		}
+		else{
+			find_blocks(skiplist, lowest_key - 1, update);
+		}
+		unlink_block(update, block);
+		free_block(skiplist, block);
+	}
+	return true;
+}
+
+unsigned int sl_blocked_scan_range(sl_blocked_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_blocked_visit_function visit, void* context){
+	unsigned int visited_count = 0;
+
+	sl_block* block = find_blocks(skiplist, minimum_key, NULL);
+	unsigned int index = 0;
+	if(block == skiplist->head)
+		block = block->next_in_layer[0];
+	else
+		index = get_lower_bound(block, minimum_key);
+
+	//Visit the keys of the blocks from the first key >= minimum_key on:
+	for(; block != NULL; block = block->next_in_layer[0], index = 0){
+		for(; index < block->count; index++){
+			if(block->keys[index] > maximum_key)
+				return visited_count;
+			visited_count++;
+			//Stop when visit() asks for it:
+			if(!visit(block->keys[index], block->data[index], context))
+				return visited_count;
+		}
+	}
+	return visited_count;
+}
+
+unsigned int sl_blocked_get_node_count(sl_blocked_skip_list* skiplist){
+	return skiplist->node_count;
+}
+
+size_t sl_blocked_get_memory_usage(sl_blocked_skip_list* skiplist){
+	return skiplist->allocated_bytes;
+}
+
+void sl_blocked_set_seed(sl_blocked_skip_list* skiplist, uint64_t seed){
+	skiplist->random_state = sl_random_state(seed);
+}
@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "skiplist_concurrent.h"
+#include "skiplist_epoch.h"
+#include "skiplist_random.h"
+
+//Lowest bit of a next pointer, set as soon as the node is removed from this layer
+#define MARK_BIT ((uintptr_t)1)
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//node, next_in_layer holds height + 1 tagged pointers
+typedef struct _sl_concurrent_node{
+	//first member, retired nodes are freed through it
+	sl_epoch_entry entry;
+	unsigned int key;
+	unsigned int height;
+	_Atomic(void*) data;
+	//the inserting thread and the skip list hold one reference each, the last one retires the node
+	atomic_uint references;
+	_Atomic uintptr_t next_in_layer[];
+}sl_concurrent_node;
+
+struct _sl_concurrent_skip_list{
+	//sentinel in front of all nodes, its key is never compared
+	sl_concurrent_node* head;
+	unsigned int layer_count;
+};
+
+//every thread draws random heights from its own xorshift state, 0 until it is seeded
+static _Thread_local uint64_t height_state = 0;
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+sl_concurrent_node* get_unmarked(uintptr_t next){
+	return (sl_concurrent_node*)(next & ~MARK_BIT);
+}
+
+bool is_marked(uintptr_t next){
+	return (next & MARK_BIT) != 0;
+}
+
+unsigned int get_concurrent_height(unsigned int maximum){
+	//The first insertion of a thread without sl_concurrent_set_seed() seeds its generator:
+	if(height_state == 0)
+		height_state = sl_random_state(sl_random_default_seed(&height_state));
+	return sl_random_height(&height_state, maximum);
+}
+
+sl_concurrent_node* create_concurrent_node(unsigned int key, void* data, unsigned int height){
+	sl_concurrent_node* node = malloc(sizeof(sl_concurrent_node) + (height + 1) * sizeof(_Atomic uintptr_t));
+	if(node == NULL)
+		return NULL;
+	node->key = key;
+	node->height = height;
+	atomic_init(&node->data, data);
+	//One reference of the inserting thread and one of the skip list:
+	atomic_init(&node->references, 2);
+	for(unsigned int i = 0; i <= height; i++)
+		atomic_init(&node->next_in_layer[i], 0);
+	return node;
+}
+
+void release_concurrent_node(sl_epoch_entry* entry){
+	free(entry);
+}
+
+void release_reference(sl_concurrent_node* node){
+	//Release: the writes of this thread happen before the node is freed, acquire: the last thread sees the
+	//writes of all others before it retires the node:
+	if(atomic_fetch_sub_explicit(&node->references, 1, memory_order_acq_rel) == 1)
+		sl_epoch_retire(&node->entry, release_concurrent_node);
+}
+
+//Searches the predecessors and successors of key in every layer and unlinks marked nodes on the way,
+//returns true if an unmarked node with key was found (it's in successors[0])
+bool find_concurrent_nodes(sl_concurrent_skip_list* skiplist, unsigned int key, sl_concurrent_node** predecessors,
+		sl_concurrent_node** successors){
+retry:;
+	sl_concurrent_node* predecessor = skiplist->head;
+	for(int layer = skiplist->layer_count - 1; layer >= 0; layer--){
+		//Acquire pairs with the release of the CAS that linked current, so its key and next pointers are visible:
+		sl_concurrent_node* current = get_unmarked(atomic_load_explicit(&predecessor->next_in_layer[layer], memory_order_acquire));
+		while(current != NULL){
+			uintptr_t next = atomic_load_explicit(&current->next_in_layer[layer], memory_order_acquire);
+			if(is_marked(next)){
+				//Unlink the removed node, start again if predecessor changed or got removed itself. Release
+				//publishes next to the threads that read predecessor after the CAS:
+				uintptr_t expected = (uintptr_t)current;
+				if(!atomic_compare_exchange_strong_explicit(&predecessor->next_in_layer[layer], &expected, next & ~MARK_BIT,
+						memory_order_acq_rel, memory_order_acquire))
+					goto retry;
+				current = get_unmarked(next);
+				continue;
+			}
+			//Stop at the first key that isn't smaller:
+			if(current->key >= key)
+				break;
+			predecessor = current;
+			current = get_unmarked(next);
+		}
+		//Remember the position in this layer, the search continues one layer below:
+		predecessors[layer] = predecessor;
+		successors[layer] = current;
+	}
+	return successors[0] != NULL  &&  successors[0]->key == key;
+}
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+sl_concurrent_skip_list* sl_create_concurrent_skip_list(unsigned int amount_of_layers){
+	if(amount_of_layers == 0)
+		return NULL;
+	sl_concurrent_skip_list* skiplist = malloc(sizeof(sl_concurrent_skip_list));
+	if(skiplist == NULL)
+		return NULL;
+	skiplist->layer_count = amount_of_layers;
+	//The head has all layers:
+	skiplist->head = create_concurrent_node(0, NULL, amount_of_layers - 1);
+	if(skiplist->head == NULL){
+		free(skiplist);
+		return NULL;
+	}
+	return skiplist;
+}
+
+void sl_remove_concurrent_skip_list(sl_concurrent_skip_list* skiplist){
+	//Removed nodes are already unlinked and wait for reclamation, the rest is freed right away:
+	sl_concurrent_node* node = skiplist->head;
+	while(node != NULL){
+		sl_concurrent_node* next_node = get_unmarked(atomic_load_explicit(&node->next_in_layer[0], memory_order_relaxed));
+		free(node);
+		node = next_node;
+	}
+	free(skiplist);
+}
+
+bool sl_concurrent_insert_node(sl_concurrent_skip_list* skiplist, unsigned int key, void* data){
+	sl_concurrent_node* predecessors[skiplist->layer_count];
+	sl_concurrent_node* successors[skiplist->layer_count];
+	sl_concurrent_node* node = NULL;
+
+	sl_epoch_enter();
+	//Link layer 0, the node is part of the skip list from then on:
+	while(true){
+		if(find_concurrent_nodes(skiplist, key, predecessors, successors)){
+			//Replace the data of the existing node:
+			sl_concurrent_node* found_node = successors[0];
+			//Sequentially consistent store and load: if the node got removed before the new data was stored,
+			//this load sees the mark of the removing thread and the insertion isn't lost:
+			atomic_store(&found_node->data, data);
+			if(!is_marked(atomic_load(&found_node->next_in_layer[0]))){
+				free(node);
+				sl_epoch_exit();
+				return true;
+			}
+			continue;
+		}
+		//Create the node once, a failed CAS reuses it:
+		if(node == NULL){
+			node = create_concurrent_node(key, data, get_concurrent_height(skiplist->layer_count - 1));
+			if(node == NULL){
+				sl_epoch_exit();
+				return false;
+			}
+		}
+		//Relaxed, nobody else can read the node before the CAS below publishes it:
+		for(unsigned int i = 0; i <= node->height; i++)
+			atomic_store_explicit(&node->next_in_layer[i], (uintptr_t)successors[i], memory_order_relaxed);
+		//Release publishes key, data and next pointers of node to every thread that acquires the link:
+		uintptr_t expected = (uintptr_t)successors[0];
+		if(atomic_compare_exchange_strong_explicit(&predecessors[0]->next_in_layer[0], &expected, (uintptr_t)node,
+				memory_order_acq_rel, memory_order_acquire))
+			break;
+	}
+
+	//Link higher layers, stop as soon as another thread removes the node:
+	for(unsigned int layer = 1; layer <= node->height; layer++){
+		while(true){
+			uintptr_t next = atomic_load_explicit(&node->next_in_layer[layer], memory_order_acquire);
+			if(is_marked(next))
+				goto linked;
+			//Point the node to the current successor first. Release, readers that follow it need the
+			//successor that this thread acquired:
+			if(get_unmarked(next) != successors[layer]
+					&&  !atomic_compare_exchange_strong_explicit(&node->next_in_layer[layer], &next, (uintptr_t)successors[layer],
+						memory_order_acq_rel, memory_order_acquire))
+				continue;
+			//Link the node behind its predecessor, release like the link in layer 0:
+			uintptr_t expected = (uintptr_t)successors[layer];
+			if(atomic_compare_exchange_strong_explicit(&predecessors[layer]->next_in_layer[layer], &expected, (uintptr_t)node,
+					memory_order_acq_rel, memory_order_acquire))
+				break;
+			//The predecessor changed, search again unless the node was removed meanwhile:
+			if(!find_concurrent_nodes(skiplist, key, predecessors, successors)  ||  successors[0] != node)
+				goto linked;
+		}
+	}
+linked:
+	//A removing thread might have searched before the last layer was linked, unlink the node again:
+	if(is_marked(atomic_load_explicit(&node->next_in_layer[0], memory_order_acquire)))
+		find_concurrent_nodes(skiplist, key, predecessors, successors);
+	release_reference(node);
+	sl_epoch_exit();
+	return true;
+}
+
+bool sl_concurrent_get_data(sl_concurrent_skip_list* skiplist, unsigned int key, void** data){
+	sl_concurrent_node* predecessor = skiplist->head;
+	sl_concurrent_node* current = NULL;
+	bool found = false;
+
+	sl_epoch_enter();
+	for(int layer = skiplist->layer_count - 1; layer >= 0; layer--){
+		//Acquire like find_concurrent_nodes(), the nodes are read after their links:
+		current = get_unmarked(atomic_load_explicit(&predecessor->next_in_layer[layer], memory_order_acquire));
+		while(current != NULL){
+			uintptr_t next = atomic_load_explicit(&current->next_in_layer[layer], memory_order_acquire);
+			//Skip removed nodes without unlinking them:
+			if(is_marked(next)){
+				current = get_unmarked(next);
+				continue;
+			}
+			//Stop at the first key that isn't smaller:
+			if(current->key >= key)
+				break;
+			predecessor = current;
+			current = get_unmarked(next);
+		}
+	}
+	//Return the data of the node with key, acquire pairs with the store of the inserting thread:
+	if(current != NULL  &&  current->key == key){
+		found = true;
+		if(data != NULL)
+			*data = atomic_load_explicit(&current->data, memory_order_acquire);
+	}
+	sl_epoch_exit();
+	return found;
+}
+
+bool sl_concurrent_remove_node(sl_concurrent_skip_list* skiplist, unsigned int key){
+	sl_concurrent_node* predecessors[skiplist->layer_count];
+	sl_concurrent_node* successors[skiplist->layer_count];
+
+	sl_epoch_enter();
+	if(!find_concurrent_nodes(skiplist, key, predecessors, successors)){
+		sl_epoch_exit();
+		return false;
+	}
+	sl_concurrent_node* node = successors[0];
+
+	//Mark higher layers top-down, layer 0 decides which thread removed the node. A failed CAS updates next:
+	for(unsigned int layer = node->height; layer > 0; layer--){
+		uintptr_t next = atomic_load_explicit(&node->next_in_layer[layer], memory_order_acquire);
+		while(!is_marked(next))
+			atomic_compare_exchange_weak_explicit(&node->next_in_layer[layer], &next, next | MARK_BIT,
+					memory_order_acq_rel, memory_order_acquire);
+	}
+	//Mark layer 0, sequentially consistent to pair with the data store and load of sl_concurrent_insert_node():
+	uintptr_t next = atomic_load(&node->next_in_layer[0]);
+	while(true){
+		//Another thread removed the node first:
+		if(is_marked(next)){
+			sl_epoch_exit();
+			return false;
+		}
+		if(atomic_compare_exchange_weak(&node->next_in_layer[0], &next, next | MARK_BIT))
+			break;
+	}
+
+	//Unlink the node in all layers before it's retired:
+	find_concurrent_nodes(skiplist, key, predecessors, successors);
+	release_reference(node);
+	sl_epoch_exit();
+	return true;
+}
+
+unsigned int sl_concurrent_get_node_count(sl_concurrent_skip_list* skiplist){
+	unsigned int node_count = 0;
+
+	sl_epoch_enter();
+	//Count all unmarked nodes of layer 0, acquire to read the nodes behind the links:
+	sl_concurrent_node* node = get_unmarked(atomic_load_explicit(&skiplist->head->next_in_layer[0], memory_order_acquire));
+	while(node != NULL){
+		uintptr_t next = atomic_load_explicit(&node->next_in_layer[0], memory_order_acquire);
+		if(!is_marked(next))
+			node_count++;
+		node = get_unmarked(next);
+	}
+	sl_epoch_exit();
+	return node_count;
+}
+
+void sl_concurrent_set_seed(uint64_t seed){
+	height_state = sl_random_state(seed);
+}
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "skiplist_epoch.h"
+
+//Retired objects of epoch e are freed when the global epoch reaches e + 2, so three limbo lists are enough
+#define EPOCH_LIMBO_LISTS 3
+//Every thread tries to advance the global epoch after this many retired objects
+#define EPOCH_ADVANCE_INTERVAL 64
+//Records of different threads never share a cache line
+#define EPOCH_CACHE_LINE_SIZE 64
+
+/*****************************************************************/
+/*************************** Records *****************************/
+/*****************************************************************/
+
+//one record per thread, records are never freed but reused by new threads
+typedef struct _sl_epoch_record{
+	_Alignas(EPOCH_CACHE_LINE_SIZE) struct _sl_epoch_record* next_record;
+	//(epoch << 1) | 1 inside a critical section, 0 outside
+	_Atomic uint64_t state;
+	atomic_bool is_used;
+	//only touched by the owning thread
+	unsigned int depth;
+	unsigned int retired_count;
+}sl_epoch_record;
+
+static _Atomic uint64_t global_epoch = 0;
+static _Atomic(sl_epoch_record*) records = NULL;
+static _Atomic(sl_epoch_entry*) limbo[EPOCH_LIMBO_LISTS];
+
+static pthread_once_t record_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t record_key;
+static _Thread_local sl_epoch_record* local_record = NULL;
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+void release_record(void* pointer){
+	sl_epoch_record* record = pointer;
+	//Leave any critical section, release: the thread's reads of shared objects happen before they're freed:
+	atomic_store_explicit(&record->state, 0, memory_order_release);
+	//Release hands the record over to the next thread that acquires is_used:
+	atomic_store_explicit(&record->is_used, false, memory_order_release);
+}
+
+void create_record_key(void){
+	pthread_key_create(&record_key, release_record);
+}
+
+sl_epoch_record* get_record(void){
+	if(local_record != NULL)
+		return local_record;
+	pthread_once(&record_key_once, create_record_key);
+
+	//Reuse the record of a finished thread, acquire pairs with the release of the thread that left it:
+	sl_epoch_record* record = atomic_load_explicit(&records, memory_order_acquire);
+	while(record != NULL){
+		bool expected = false;
+		if(!atomic_load_explicit(&record->is_used, memory_order_relaxed)
+				&&  atomic_compare_exchange_strong_explicit(&record->is_used, &expected, true, memory_order_acquire, memory_order_relaxed))
+			break;
+		record = record->next_record;
+	}
+
+	//Otherwise push a new record, release publishes it to threads that acquire records:
+	if(record == NULL){
+		record = aligned_alloc(EPOCH_CACHE_LINE_SIZE, sizeof(sl_epoch_record));
+		if(record == NULL)
+			abort();
+		atomic_init(&record->state, 0);
+		atomic_init(&record->is_used, true);
+		sl_epoch_record* head = atomic_load_explicit(&records, memory_order_relaxed);
+		do{
+			record->next_record = head;
+		}while(!atomic_compare_exchange_weak_explicit(&records, &head, record, memory_order_release, memory_order_relaxed));
+	}
+
+	//The thread frees the record at its end:
+	record->depth = 0;
+	record->retired_count = 0;
+	pthread_setspecific(record_key, record);
+	local_record = record;
+	return record;
+}
+
+void release_entries(sl_epoch_entry* entry){
+	while(entry != NULL){
+		sl_epoch_entry* next_entry = entry->next_retired;
+		entry->release(entry);
+		entry = next_entry;
+	}
+}
+
+//Advances the global epoch if all threads inside a critical section have seen it
+bool try_advance(void){
+	//Sequentially consistent like sl_epoch_enter(), a thread that entered after this check sees the new epoch:
+	uint64_t epoch = atomic_load(&global_epoch);
+	for(sl_epoch_record* record = atomic_load_explicit(&records, memory_order_acquire); record != NULL; record = record->next_record){
+		uint64_t state = atomic_load(&record->state);
+		if((state & 1)  &&  (state >> 1) != epoch)
+			return false;
+	}
+	//Another thread advanced it:
+	if(!atomic_compare_exchange_strong(&global_epoch, &epoch, epoch + 1))
+		return true;
+	//Objects of epoch - 1 can't be reached anymore, acquire pairs with the release of sl_epoch_retire():
+	release_entries(atomic_exchange_explicit(&limbo[(epoch + 2) % EPOCH_LIMBO_LISTS], NULL, memory_order_acquire));
+	return true;
+}
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+void sl_epoch_enter(void){
+	sl_epoch_record* record = get_record();
+	//Nested critical sections keep the epoch of the outermost one:
+	if(record->depth++ > 0)
+		return;
+	//Announce the epoch, then check it's still the global one. Both are sequentially consistent, otherwise the
+	//load could pass the store and try_advance() wouldn't see this thread:
+	uint64_t epoch = atomic_load(&global_epoch);
+	while(true){
+		atomic_store(&record->state, (epoch << 1) | 1);
+		uint64_t current_epoch = atomic_load(&global_epoch);
+		if(current_epoch == epoch)
+			break;
+		epoch = current_epoch;
+	}
+}
+
+void sl_epoch_exit(void){
+	sl_epoch_record* record = local_record;
+	//Release: all reads inside the critical section happen before the objects can be freed:
+	if(--record->depth == 0)
+		atomic_store_explicit(&record->state, 0, memory_order_release);
+}
+
+void sl_epoch_retire(sl_epoch_entry* entry, void (*release)(sl_epoch_entry* entry)){
+	sl_epoch_record* record = local_record;
+	entry->release = release;
+	//The epoch has to be read after the object was unlinked, sequentially consistent keeps the load behind it:
+	uint64_t epoch = atomic_load(&global_epoch);
+	//Push the entry to the limbo list of epoch, release publishes entry to the thread that frees it:
+	_Atomic(sl_epoch_entry*)* list = &limbo[epoch % EPOCH_LIMBO_LISTS];
+	sl_epoch_entry* head = atomic_load_explicit(list, memory_order_relaxed);
+	do{
+		entry->next_retired = head;
+	}while(!atomic_compare_exchange_weak_explicit(list, &head, entry, memory_order_release, memory_order_relaxed));
+	//Free older limbo lists from time to time:
+	if(++record->retired_count % EPOCH_ADVANCE_INTERVAL == 0)
+		try_advance();
+}
+
+void sl_epoch_synchronize(void){
+	uint64_t target_epoch = atomic_load(&global_epoch) + 2;
+	//try_advance() has to run inside a critical section, the limbo list it frees must not be filled meanwhile
+	while(atomic_load(&global_epoch) < target_epoch){
+		sl_epoch_enter();
+		bool advanced = try_advance();
+		sl_epoch_exit();
+		//Threads in older epochs have to leave their critical sections first:
+		if(!advanced)
+			sched_yield();
+	}
+}
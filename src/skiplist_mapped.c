@@ -0,0 +1,547 @@
+//mremap() keeps the private pages of the mapping when the file grows:
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "skiplist_mapped.h"
+#include "skiplist_random.h"
+
+//Identifies files of sl_open_mapped_skip_list(), the last characters are the version of the format
+#define MAPPED_MAGIC "SLMAP002"
+//Identifies the redo log at the end of a file
+#define MAPPED_LOG_MAGIC "SLLOG001"
+//Size of a new file, the file doubles whenever the bump allocator reaches its end
+#define MAPPED_INITIAL_BYTES 65536
+//Checkpoints write whole pages, the file size is always a multiple of it
+#define MAPPED_PAGE_BYTES 4096
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//header at offset 0 of the file, offset 0 is also the end of a layer because no node lies there
+typedef struct{
+	char magic[8];
+	uint32_t layer_count;
+	uint32_t node_count;
+	//head node, in front of all nodes with layer_count layers
+	uint64_t head_offset;
+	//nodes are allocated in front of bump_offset, the rest of the file is unused
+	uint64_t bump_offset;
+	uint64_t random_state;
+	//size of the file at the checkpoint that wrote this header, anything behind it is ignored
+	uint64_t file_size;
+	//removed nodes of every height, linked by next_in_layer[0]
+	uint64_t free_nodes[SL_MAPPED_MAX_LAYERS];
+	//checksum of all members in front of it, written by every checkpoint
+	uint64_t checksum;
+}sl_mapped_header;
+
+//node in the file, next_in_layer holds height + 1 offsets
+typedef struct{
+	uint64_t value;
+	uint32_t key;
+	uint32_t height;
+	uint64_t next_in_layer[];
+}sl_mapped_node;
+
+//end of the redo log behind file_size: page_count pages, their page_count indexes, then this trailer
+typedef struct{
+	char magic[8];
+	uint64_t file_size;
+	uint64_t page_count;
+	//checksum of the pages, the indexes and the members in front of it
+	uint64_t checksum;
+}sl_mapped_log_trailer;
+
+struct _sl_mapped_skip_list{
+	int fd;
+	//private mapping of the whole file, its address changes when the file grows. Changes reach the file
+	//only through sl_mapped_checkpoint()
+	unsigned char* base;
+	size_t size;
+	//one bit per page that was changed since the last checkpoint
+	uint64_t* dirty_pages;
+	//bytes of a committed redo log behind size whose pages aren't written in place yet, 0 if there's none
+	size_t pending_log_size;
+};
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+sl_mapped_header* get_mapped_header(sl_mapped_skip_list* skiplist){
+	return (sl_mapped_header*)skiplist->base;
+}
+
+sl_mapped_node* get_mapped_node(sl_mapped_skip_list* skiplist, uint64_t offset){
+	return (sl_mapped_node*)(skiplist->base + offset);
+}
+
+size_t get_mapped_node_size(unsigned int height){
+	return sizeof(sl_mapped_node) + (height + 1) * sizeof(uint64_t);
+}
+
+size_t get_dirty_words(size_t size){
+	return (size / MAPPED_PAGE_BYTES + 63) / 64;
+}
+
+//Remembers the pages of size bytes at offset for the next checkpoint
+void mark_mapped_dirty(sl_mapped_skip_list* skiplist, uint64_t offset, size_t size){
+	for(uint64_t page = offset / MAPPED_PAGE_BYTES; page <= (offset + size - 1) / MAPPED_PAGE_BYTES; page++)
+		skiplist->dirty_pages[page / 64] |= 1ULL << (page % 64);
+}
+
+bool is_mapped_dirty(sl_mapped_skip_list* skiplist, uint64_t page){
+	return (skiplist->dirty_pages[page / 64] >> (page % 64)) & 1;
+}
+
+//FNV-1a, continues checksum with size bytes
+uint64_t get_mapped_checksum(uint64_t checksum, const void* bytes, size_t size){
+	const unsigned char* current_byte = bytes;
+	for(size_t i = 0; i < size; i++)
+		checksum = (checksum ^ current_byte[i]) * 0x100000001B3ULL;
+	return checksum;
+}
+
+uint64_t get_header_checksum(const sl_mapped_header* header){
+	return get_mapped_checksum(0xCBF29CE484222325ULL, header, offsetof(sl_mapped_header, checksum));
+}
+
+unsigned int get_mapped_height(sl_mapped_skip_list* skiplist){
+	//The state is part of the file, a reopened skip list continues its sequence:
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	mark_mapped_dirty(skiplist, 0, sizeof(sl_mapped_header));
+	return sl_random_height(&header->random_state, header->layer_count - 1);
+}
+
+bool map_file(sl_mapped_skip_list* skiplist, size_t size){
+	//Private, the kernel never writes a page back on its own:
+	void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, skiplist->fd, 0);
+	if(base == MAP_FAILED)
+		return false;
+	skiplist->dirty_pages = calloc(get_dirty_words(size), sizeof(uint64_t));
+	if(skiplist->dirty_pages == NULL){
+		munmap(base, size);
+		return false;
+	}
+	skiplist->base = base;
+	skiplist->size = size;
+	return true;
+}
+
+//Checks the redo log at the end of the file, returns its page indexes (NULL if there's no complete log)
+uint64_t* read_mapped_log(int fd, size_t size, sl_mapped_log_trailer* trailer){
+	if(size < sizeof(sl_mapped_log_trailer)  ||  pread(fd, trailer, sizeof(sl_mapped_log_trailer), size - sizeof(sl_mapped_log_trailer)) != sizeof(sl_mapped_log_trailer))
+		return NULL;
+	//The size of the log has to fit exactly, a torn log has no trailer or a wrong one:
+	if(memcmp(trailer->magic, MAPPED_LOG_MAGIC, sizeof(trailer->magic)) != 0  ||  trailer->file_size % MAPPED_PAGE_BYTES != 0  ||
+			trailer->file_size < MAPPED_PAGE_BYTES  ||  trailer->page_count > trailer->file_size / MAPPED_PAGE_BYTES  ||
+			trailer->file_size + trailer->page_count * (MAPPED_PAGE_BYTES + sizeof(uint64_t)) + sizeof(sl_mapped_log_trailer) != size)
+		return NULL;
+
+	uint64_t* page_indexes = malloc(trailer->page_count * sizeof(uint64_t) + 1);
+	unsigned char* page = malloc(MAPPED_PAGE_BYTES);
+	bool is_complete = page_indexes != NULL  &&  page != NULL;
+	uint64_t checksum = 0xCBF29CE484222325ULL;
+	uint64_t log_offset = trailer->file_size;
+
+	//Sum up the pages, their indexes and the trailer like sl_mapped_checkpoint():
+	for(uint64_t i = 0; is_complete  &&  i < trailer->page_count; i++){
+		is_complete = pread(fd, page, MAPPED_PAGE_BYTES, log_offset + i * MAPPED_PAGE_BYTES) == MAPPED_PAGE_BYTES;
+		checksum = get_mapped_checksum(checksum, page, MAPPED_PAGE_BYTES);
+	}
+	size_t indexes_size = trailer->page_count * sizeof(uint64_t);
+	is_complete = is_complete  &&  pread(fd, page_indexes, indexes_size, log_offset + trailer->page_count * MAPPED_PAGE_BYTES) == (ssize_t)indexes_size;
+	if(is_complete){
+		checksum = get_mapped_checksum(checksum, page_indexes, indexes_size);
+		checksum = get_mapped_checksum(checksum, trailer, offsetof(sl_mapped_log_trailer, checksum));
+		is_complete = checksum == trailer->checksum;
+	}
+	for(uint64_t i = 0; is_complete  &&  i < trailer->page_count; i++)
+		is_complete = page_indexes[i] < trailer->file_size / MAPPED_PAGE_BYTES;
+
+	free(page);
+	if(!is_complete){
+		free(page_indexes);
+		return NULL;
+	}
+	return page_indexes;
+}
+
+//Writes the pages of a complete redo log in place and removes the log after they are on disk, frees page_indexes
+bool replay_mapped_log(int fd, const sl_mapped_log_trailer* trailer, uint64_t* page_indexes){
+	unsigned char* page = malloc(MAPPED_PAGE_BYTES);
+	bool is_replayed = page != NULL;
+	for(uint64_t i = 0; is_replayed  &&  i < trailer->page_count; i++)
+		is_replayed = pread(fd, page, MAPPED_PAGE_BYTES, trailer->file_size + i * MAPPED_PAGE_BYTES) == MAPPED_PAGE_BYTES  &&
+					  pwrite(fd, page, MAPPED_PAGE_BYTES, page_indexes[i] * MAPPED_PAGE_BYTES) == MAPPED_PAGE_BYTES;
+	free(page);
+	free(page_indexes);
+	return is_replayed  &&  fsync(fd) == 0  &&  ftruncate(fd, trailer->file_size) == 0  &&  fsync(fd) == 0;
+}
+
+//Replays the log of a checkpoint that was committed but failed while writing its pages in place. Until that
+//succeeds the log is the only intact copy of those pages, nothing may truncate or overwrite it
+bool finish_mapped_checkpoint(sl_mapped_skip_list* skiplist){
+	if(skiplist->pending_log_size == 0)
+		return true;
+	sl_mapped_log_trailer trailer;
+	uint64_t* page_indexes = read_mapped_log(skiplist->fd, skiplist->size + skiplist->pending_log_size, &trailer);
+	if(page_indexes == NULL  ||  trailer.file_size != skiplist->size  ||  !replay_mapped_log(skiplist->fd, &trailer, page_indexes))
+		return false;
+	skiplist->pending_log_size = 0;
+	return true;
+}
+
+bool grow_mapping(sl_mapped_skip_list* skiplist, size_t needed_bytes){
+	//The new size would cut or bury a committed log:
+	if(!finish_mapped_checkpoint(skiplist))
+		return false;
+
+	//Double the file, offsets stay valid when the mapping moves:
+	size_t new_size = skiplist->size * 2;
+	if(new_size < skiplist->size + needed_bytes)
+		new_size = (skiplist->size + needed_bytes + MAPPED_PAGE_BYTES - 1) / MAPPED_PAGE_BYTES * MAPPED_PAGE_BYTES;
+	uint64_t* dirty_pages = realloc(skiplist->dirty_pages, get_dirty_words(new_size) * sizeof(uint64_t));
+	if(dirty_pages == NULL)
+		return false;
+	skiplist->dirty_pages = dirty_pages;
+	memset(dirty_pages + get_dirty_words(skiplist->size), 0, (get_dirty_words(new_size) - get_dirty_words(skiplist->size)) * sizeof(uint64_t));
+
+	//The new pages are zeros of the file, the changed pages of the old mapping move along:
+	if(ftruncate(skiplist->fd, new_size) != 0)
+		return false;
+	//If it fails, the next checkpoint or open cuts the file back to the size of the mapping:
+	void* base = mremap(skiplist->base, skiplist->size, new_size, MREMAP_MAYMOVE);
+	if(base == MAP_FAILED)
+		return false;
+	skiplist->base = base;
+	skiplist->size = new_size;
+	return true;
+}
+
+//Returns the offset of a node with height, 0 if the file couldn't be enlarged
+uint64_t allocate_mapped_node(sl_mapped_skip_list* skiplist, unsigned int height){
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	mark_mapped_dirty(skiplist, 0, sizeof(sl_mapped_header));
+
+	//Reuse a removed node of the same height:
+	uint64_t offset = header->free_nodes[height];
+	if(offset != 0){
+		header->free_nodes[height] = get_mapped_node(skiplist, offset)->next_in_layer[0];
+		return offset;
+	}
+
+	size_t node_size = get_mapped_node_size(height);
+	if(header->bump_offset + node_size > skiplist->size  &&  !grow_mapping(skiplist, node_size))
+		return 0;
+	//The mapping may have moved:
+	header = get_mapped_header(skiplist);
+	offset = header->bump_offset;
+	header->bump_offset += node_size;
+	return offset;
+}
+
+//Searches the last node in front of key in every layer, returns the offset of the first node >= key (or 0)
+uint64_t find_mapped_nodes(sl_mapped_skip_list* skiplist, unsigned int key, uint64_t* update){
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	uint64_t current_offset = header->head_offset;
+	uint64_t next_offset = 0;
+
+	for(int current_layer = header->layer_count - 1; current_layer >= 0; current_layer--){
+		next_offset = get_mapped_node(skiplist, current_offset)->next_in_layer[current_layer];
+		while(next_offset != 0  &&  get_mapped_node(skiplist, next_offset)->key < key){
+			current_offset = next_offset;
+			next_offset = get_mapped_node(skiplist, current_offset)->next_in_layer[current_layer];
+		}
+		if(update != NULL)
+			update[current_layer] = current_offset;
+	}
+	return next_offset;
+}
+
+bool initialize_mapped_file(sl_mapped_skip_list* skiplist, unsigned int layers){
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	memset(header, 0, sizeof(sl_mapped_header));
+	memcpy(header->magic, MAPPED_MAGIC, sizeof(header->magic));
+	header->layer_count = layers;
+	header->bump_offset = sizeof(sl_mapped_header);
+	//Every file gets its own seed, use sl_mapped_set_seed() for reproducible heights:
+	header->random_state = sl_random_state(sl_random_default_seed(skiplist));
+
+	//The head is the first node behind the header:
+	uint64_t head_offset = allocate_mapped_node(skiplist, layers - 1);
+	if(head_offset == 0)
+		return false;
+	header = get_mapped_header(skiplist);
+	sl_mapped_node* head = get_mapped_node(skiplist, head_offset);
+	head->key = 0;
+	head->value = 0;
+	head->height = layers - 1;
+	for(unsigned int i = 0; i < layers; i++)
+		head->next_in_layer[i] = 0;
+	header->head_offset = head_offset;
+	mark_mapped_dirty(skiplist, head_offset, get_mapped_node_size(layers - 1));
+
+	//Until this checkpoint the file holds no header, it's initialized again at the next open:
+	return sl_mapped_checkpoint(skiplist);
+}
+
+bool is_valid_mapped_file(sl_mapped_skip_list* skiplist){
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	return header->checksum == get_header_checksum(header)  &&  header->file_size == skiplist->size  &&
+		   header->layer_count > 0  &&  header->layer_count <= SL_MAPPED_MAX_LAYERS  &&
+		   header->bump_offset <= skiplist->size  &&  header->head_offset >= sizeof(sl_mapped_header)  &&
+		   header->head_offset + get_mapped_node_size(header->layer_count - 1) <= header->bump_offset;
+}
+
+//Brings the file to the state of its last checkpoint: a complete redo log is written to its pages, a torn
+//one and pages that were added after the checkpoint are cut off
+bool recover_mapped_file(int fd){
+	struct stat file_status;
+	if(fstat(fd, &file_status) != 0)
+		return false;
+	size_t size = file_status.st_size;
+
+	//Replay the log, its pages may be written in place only partly:
+	sl_mapped_log_trailer trailer;
+	uint64_t* page_indexes = read_mapped_log(fd, size, &trailer);
+	if(page_indexes != NULL)
+		return replay_mapped_log(fd, &trailer, page_indexes);
+
+	//Without a log the header of the last checkpoint is intact, it knows the size of the file then:
+	sl_mapped_header header;
+	if(size <= sizeof(sl_mapped_header)  ||  pread(fd, &header, sizeof(sl_mapped_header), 0) != sizeof(sl_mapped_header)  ||
+			memcmp(header.magic, MAPPED_MAGIC, sizeof(header.magic)) != 0  ||  header.checksum != get_header_checksum(&header)  ||
+			header.file_size >= size)
+		return true;
+	return ftruncate(fd, header.file_size) == 0  &&  fsync(fd) == 0;
+}
+
+/*****************************************************************/
+/*************************** Public ******************************/
+/*****************************************************************/
+
+sl_mapped_skip_list* sl_open_mapped_skip_list(const char* path, unsigned int amount_of_layers){
+	sl_mapped_skip_list* skiplist = malloc(sizeof(sl_mapped_skip_list));
+	if(skiplist == NULL)
+		return NULL;
+
+	skiplist->pending_log_size = 0;
+	skiplist->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if(skiplist->fd < 0){
+		free(skiplist);
+		return NULL;
+	}
+
+	//Finish or drop the checkpoint that a crash interrupted, then a new file gets the initial size:
+	struct stat file_status;
+	bool is_opened = recover_mapped_file(skiplist->fd)  &&  fstat(skiplist->fd, &file_status) == 0;
+	size_t size = is_opened ? (size_t)file_status.st_size : 0;
+	if(is_opened  &&  size == 0){
+		size = MAPPED_INITIAL_BYTES;
+		is_opened = ftruncate(skiplist->fd, size) == 0;
+	}
+	is_opened = is_opened  &&  size >= sizeof(sl_mapped_header)  &&  size % MAPPED_PAGE_BYTES == 0  &&  map_file(skiplist, size);
+	if(!is_opened){
+		close(skiplist->fd);
+		free(skiplist);
+		return NULL;
+	}
+
+	//Only the header is read, the nodes are used where they are. A file without magic was never
+	//initialized completely:
+	if(memcmp(get_mapped_header(skiplist)->magic, MAPPED_MAGIC, sizeof(get_mapped_header(skiplist)->magic)) == 0)
+		is_opened = is_valid_mapped_file(skiplist);
+	else{
+		char empty_magic[sizeof(get_mapped_header(skiplist)->magic)] = { 0 };
+		is_opened = memcmp(get_mapped_header(skiplist)->magic, empty_magic, sizeof(empty_magic)) == 0  &&
+					amount_of_layers > 0  &&  amount_of_layers <= SL_MAPPED_MAX_LAYERS  &&
+					initialize_mapped_file(skiplist, amount_of_layers);
+	}
+	if(!is_opened){
+		munmap(skiplist->base, skiplist->size);
+		free(skiplist->dirty_pages);
+		close(skiplist->fd);
+		free(skiplist);
+		return NULL;
+	}
+	return skiplist;
+}
+
+bool sl_close_mapped_skip_list(sl_mapped_skip_list* skiplist){
+	bool is_written = sl_mapped_checkpoint(skiplist);
+	munmap(skiplist->base, skiplist->size);
+	free(skiplist->dirty_pages);
+	is_written = close(skiplist->fd) == 0  &&  is_written;
+	free(skiplist);
+	return is_written;
+}
+
+bool sl_mapped_checkpoint(sl_mapped_skip_list* skiplist){
+	//A new log replaces the file end, the pages of an earlier committed log have to be in place before:
+	if(!finish_mapped_checkpoint(skiplist))
+		return false;
+
+	size_t page_count = skiplist->size / MAPPED_PAGE_BYTES;
+	size_t dirty_count = 0;
+	for(size_t page = 0; page < page_count; page++)
+		dirty_count += is_mapped_dirty(skiplist, page);
+	if(dirty_count == 0)
+		return true;
+
+	//The header of this checkpoint is written like every other page:
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	header->file_size = skiplist->size;
+	header->checksum = get_header_checksum(header);
+	uint64_t* page_indexes = malloc(dirty_count * sizeof(uint64_t));
+	if(page_indexes == NULL)
+		return false;
+
+	//Append the redo log behind the pages, anything left behind the mapping by a failed growth is dropped first:
+	sl_mapped_log_trailer trailer;
+	memcpy(trailer.magic, MAPPED_LOG_MAGIC, sizeof(trailer.magic));
+	trailer.file_size = skiplist->size;
+	trailer.page_count = dirty_count;
+	uint64_t checksum = 0xCBF29CE484222325ULL;
+	uint64_t log_offset = skiplist->size;
+	bool is_written = ftruncate(skiplist->fd, skiplist->size) == 0;
+	size_t log_index = 0;
+	for(size_t page = 0; is_written  &&  page < page_count; page++){
+		if(!is_mapped_dirty(skiplist, page))
+			continue;
+		unsigned char* page_bytes = skiplist->base + page * MAPPED_PAGE_BYTES;
+		is_written = pwrite(skiplist->fd, page_bytes, MAPPED_PAGE_BYTES, log_offset + log_index * MAPPED_PAGE_BYTES) == MAPPED_PAGE_BYTES;
+		checksum = get_mapped_checksum(checksum, page_bytes, MAPPED_PAGE_BYTES);
+		page_indexes[log_index++] = page;
+	}
+	size_t indexes_size = dirty_count * sizeof(uint64_t);
+	checksum = get_mapped_checksum(checksum, page_indexes, indexes_size);
+	trailer.checksum = get_mapped_checksum(checksum, &trailer, offsetof(sl_mapped_log_trailer, checksum));
+	is_written = is_written  &&  pwrite(skiplist->fd, page_indexes, indexes_size, log_offset + dirty_count * MAPPED_PAGE_BYTES) == (ssize_t)indexes_size  &&
+				 pwrite(skiplist->fd, &trailer, sizeof(trailer), log_offset + dirty_count * (MAPPED_PAGE_BYTES + sizeof(uint64_t))) == sizeof(trailer);
+
+	//The checkpoint is committed as soon as the log is on disk, a crash after it replays the log at the next open:
+	bool is_committed = is_written  &&  fsync(skiplist->fd) == 0;
+
+	//Write the pages in place, then drop the log. It's only dropped after the pages are on disk:
+	is_written = is_committed;
+	for(size_t i = 0; is_written  &&  i < dirty_count; i++)
+		is_written = pwrite(skiplist->fd, skiplist->base + page_indexes[i] * MAPPED_PAGE_BYTES, MAPPED_PAGE_BYTES, page_indexes[i] * MAPPED_PAGE_BYTES) == MAPPED_PAGE_BYTES;
+	is_written = is_written  &&  fsync(skiplist->fd) == 0;
+	//The pages may be torn on disk, the next checkpoint or growth replays the log instead of cutting it off:
+	if(is_committed  &&  !is_written)
+		skiplist->pending_log_size = dirty_count * (MAPPED_PAGE_BYTES + sizeof(uint64_t)) + sizeof(trailer);
+	is_written = is_written  &&  ftruncate(skiplist->fd, skiplist->size) == 0  &&  fsync(skiplist->fd) == 0;
+	if(is_written){
+		//The file holds the pages now, their private copies aren't needed anymore:
+		for(size_t i = 0; i < dirty_count; i++)
+			madvise(skiplist->base + page_indexes[i] * MAPPED_PAGE_BYTES, MAPPED_PAGE_BYTES, MADV_DONTNEED);
+		memset(skiplist->dirty_pages, 0, get_dirty_words(skiplist->size) * sizeof(uint64_t));
+	}
+	free(page_indexes);
+	return is_written;
+}
+
+bool sl_mapped_insert_node(sl_mapped_skip_list* skiplist, unsigned int key, uint64_t value){
+	uint64_t update[get_mapped_header(skiplist)->layer_count];
+	uint64_t next_offset = find_mapped_nodes(skiplist, key, update);
+
+	//Key does already exist: replace the value in place
+	if(next_offset != 0  &&  get_mapped_node(skiplist, next_offset)->key == key){
+		get_mapped_node(skiplist, next_offset)->value = value;
+		mark_mapped_dirty(skiplist, next_offset, sizeof(sl_mapped_node));
+		return true;
+	}
+
+	//update holds offsets, they stay valid if the allocation moves the mapping:
+	unsigned int height = get_mapped_height(skiplist);
+	uint64_t offset = allocate_mapped_node(skiplist, height);
+	if(offset == 0)
+		return false;
+
+	sl_mapped_node* node = get_mapped_node(skiplist, offset);
+	node->key = key;
+	node->value = value;
+	node->height = height;
+	for(unsigned int i = 0; i <= height; i++)
+		node->next_in_layer[i] = get_mapped_node(skiplist, update[i])->next_in_layer[i];
+	mark_mapped_dirty(skiplist, offset, get_mapped_node_size(height));
+
+	//Link bottom-up:
+	for(unsigned int i = 0; i <= height; i++){
+		get_mapped_node(skiplist, update[i])->next_in_layer[i] = offset;
+		mark_mapped_dirty(skiplist, update[i] + offsetof(sl_mapped_node, next_in_layer) + i * sizeof(uint64_t), sizeof(uint64_t));
+	}
+	get_mapped_header(skiplist)->node_count++;
+	return true;
+}
+
+bool sl_mapped_get_value(sl_mapped_skip_list* skiplist, unsigned int key, uint64_t* value){
+	uint64_t offset = find_mapped_nodes(skiplist, key, NULL);
+	if(offset == 0  ||  get_mapped_node(skiplist, offset)->key != key)
+		return false;
+	if(value != NULL)
+		*value = get_mapped_node(skiplist, offset)->value;
+	return true;
+}
+
+bool sl_mapped_remove_node(sl_mapped_skip_list* skiplist, unsigned int key){
+	sl_mapped_header* header = get_mapped_header(skiplist);
+	uint64_t update[header->layer_count];
+	uint64_t offset = find_mapped_nodes(skiplist, key, update);
+	if(offset == 0  ||  get_mapped_node(skiplist, offset)->key != key)
+		return false;
+
+	//Unlink top-down:
+	sl_mapped_node* node = get_mapped_node(skiplist, offset);
+	for(int i = node->height; i >= 0; i--){
+		get_mapped_node(skiplist, update[i])->next_in_layer[i] = node->next_in_layer[i];
+		mark_mapped_dirty(skiplist, update[i] + offsetof(sl_mapped_node, next_in_layer) + i * sizeof(uint64_t), sizeof(uint64_t));
+	}
+
+	//Put the node on the free list of its height:
+	node->next_in_layer[0] = header->free_nodes[node->height];
+	mark_mapped_dirty(skiplist, offset, get_mapped_node_size(0));
+	header->free_nodes[node->height] = offset;
+	header->node_count--;
+	mark_mapped_dirty(skiplist, 0, sizeof(sl_mapped_header));
+	return true;
+}
+
+unsigned int sl_mapped_scan_range(sl_mapped_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_mapped_visit_function visit, void* context){
+	unsigned int visited_count = 0;
+
+	//Visit the nodes of layer 0 from the first key >= minimum_key on:
+	for(uint64_t offset = find_mapped_nodes(skiplist, minimum_key, NULL); offset != 0; offset = get_mapped_node(skiplist, offset)->next_in_layer[0]){
+		sl_mapped_node* node = get_mapped_node(skiplist, offset);
+		if(node->key > maximum_key)
+			break;
+		visited_count++;
+		//Stop when visit() asks for it:
+		if(!visit(node->key, node->value, context))
+			break;
+	}
+	return visited_count;
+}
+
+unsigned int sl_mapped_get_node_count(sl_mapped_skip_list* skiplist){
+	return get_mapped_header(skiplist)->node_count;
+}
+
+size_t sl_mapped_get_file_size(sl_mapped_skip_list* skiplist){
+	return skiplist->size;
+}
+
+void sl_mapped_set_seed(sl_mapped_skip_list* skiplist, uint64_t seed){
+	get_mapped_header(skiplist)->random_state = sl_random_state(seed);
+	mark_mapped_dirty(skiplist, 0, sizeof(sl_mapped_header));
+}
@@ -0,0 +1,574 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "skiplist.h"
+#include "skiplist_memtable.h"
+
+//Identifies run files, the last characters are the version of the format
+#define RUN_MAGIC "SLRUN001"
+//Every RUN_INDEX_INTERVAL-th key of a run is part of its sparse index, a lookup reads one interval
+#define RUN_INDEX_INTERVAL 64
+//Entries that the flush thread collects before one write()
+#define RUN_BUFFER_ENTRIES 4096
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//data of the nodes of the skip lists, changed in place by later writes of the same key
+typedef struct{
+	uint64_t value;
+	bool is_tombstone;
+}sl_memtable_entry;
+
+//entry of a run file
+typedef struct{
+	uint32_t key;
+	uint32_t is_tombstone;
+	uint64_t value;
+}sl_run_entry;
+
+//header of a run file, followed by entry_count entries and the sparse index at index_offset
+typedef struct{
+	char magic[8];
+	uint32_t entry_count;
+	uint32_t index_interval;
+	uint64_t index_offset;
+}sl_run_header;
+
+//run file, the sparse index is kept in memory
+typedef struct _sl_memtable_run{
+	int fd;
+	//number in the file name, newer runs have greater ones
+	unsigned int sequence;
+	unsigned int entry_count;
+	//key of every RUN_INDEX_INTERVAL-th entry
+	unsigned int* index_keys;
+	//next older run
+	struct _sl_memtable_run* next_run;
+}sl_memtable_run;
+
+//frozen skip list, no writes reach it anymore
+typedef struct _sl_frozen_list{
+	sl_skip_list* skiplist;
+	//next older frozen skip list
+	struct _sl_frozen_list* next_frozen;
+}sl_frozen_list;
+
+struct _sl_memtable{
+	char* directory;
+	unsigned int layer_count;
+	size_t flush_threshold;
+	//write lock for changes of active and the lists, read lock for lookups
+	pthread_rwlock_t lock;
+	sl_skip_list* active;
+	//newest first, the flush thread writes the oldest one
+	sl_frozen_list* frozen;
+	//newest first, runs are only added, so the chain behind a read head never changes
+	sl_memtable_run* runs;
+	//sequence of the next run, greater than the sequences of all run files found in directory
+	unsigned int run_count;
+
+	//protects the counters below and wakes the flush thread or the waiters of sl_memtable_flush()
+	pthread_mutex_t flush_mutex;
+	pthread_cond_t flush_condition;
+	pthread_cond_t flushed_condition;
+	unsigned int pending_count;
+	bool is_stopping;
+	bool is_failed;
+	pthread_t flush_thread;
+};
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+bool release_memtable_entry(sl_node* node, void* context){
+	free(node->data);
+	return true;
+}
+
+void remove_memtable_list(sl_skip_list* skiplist){
+	sl_remove_node_range_with(skiplist, 0, UINT_MAX, release_memtable_entry, NULL);
+	sl_remove_skip_list(skiplist);
+}
+
+size_t get_memtable_list_bytes(sl_skip_list* skiplist){
+	unsigned int node_count = skiplist->zero_node == NULL ? 0 : skiplist->node_count_in_layer[0];
+	return sl_get_memory_usage(skiplist) + node_count * sizeof(sl_memtable_entry);
+}
+
+//Moves the active skip list in front of the frozen ones and wakes the flush thread, needs the write lock
+bool freeze_active_list(sl_memtable* memtable){
+	sl_frozen_list* frozen = malloc(sizeof(sl_frozen_list));
+	sl_skip_list* active = sl_create_skip_list(memtable->layer_count);
+	if(frozen == NULL  ||  active == NULL){
+		free(frozen);
+		if(active != NULL)
+			sl_remove_skip_list(active);
+		return false;
+	}
+
+	frozen->skiplist = memtable->active;
+	frozen->next_frozen = memtable->frozen;
+	memtable->frozen = frozen;
+	memtable->active = active;
+
+	pthread_mutex_lock(&memtable->flush_mutex);
+	memtable->pending_count++;
+	pthread_cond_signal(&memtable->flush_condition);
+	pthread_mutex_unlock(&memtable->flush_mutex);
+	return true;
+}
+
+bool write_run_entries(int fd, const sl_run_entry* entries, size_t count){
+	//write() may write less or get interrupted:
+	const unsigned char* bytes = (const unsigned char*)entries;
+	size_t size = count * sizeof(sl_run_entry);
+	while(size > 0){
+		ssize_t written = write(fd, bytes, size);
+		if(written < 0  &&  errno == EINTR)
+			continue;
+		if(written <= 0)
+			return false;
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+
+bool sync_memtable_directory(const char* directory){
+	int fd = open(directory, O_RDONLY | O_DIRECTORY);
+	if(fd < 0)
+		return false;
+	bool is_synced = fsync(fd) == 0;
+	close(fd);
+	return is_synced;
+}
+
+//Streams layer 0 of skiplist into a new run file, returns NULL if writing failed
+sl_memtable_run* write_memtable_run(sl_memtable* memtable, sl_skip_list* skiplist, unsigned int sequence){
+	unsigned int entry_count = skiplist->zero_node == NULL ? 0 : skiplist->node_count_in_layer[0];
+	unsigned int index_count = (entry_count + RUN_INDEX_INTERVAL - 1) / RUN_INDEX_INTERVAL;
+	sl_memtable_run* run = malloc(sizeof(sl_memtable_run));
+	sl_run_entry* buffer = malloc(sizeof(sl_run_entry) * RUN_BUFFER_ENTRIES);
+	unsigned int* index_keys = malloc(sizeof(unsigned int) * (index_count + 1));
+	size_t path_size = strlen(memtable->directory) + 32;
+	char path[path_size];
+	char temporary_path[path_size];
+	snprintf(path, path_size, "%s/run-%06u.sl", memtable->directory, sequence);
+	snprintf(temporary_path, path_size, "%s/run-%06u.sl.tmp", memtable->directory, sequence);
+	//The run is written under a temporary name, only a left over of a crashed flush can be truncated:
+	int fd = run == NULL  ||  buffer == NULL  ||  index_keys == NULL ? -1 : open(temporary_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	//The header is written last, a run without it was never finished:
+	sl_run_header header;
+	memset(&header, 0, sizeof(header));
+	bool is_written = fd >= 0  &&  lseek(fd, sizeof(header), SEEK_SET) == sizeof(header);
+
+	unsigned int buffered_count = 0;
+	unsigned int position = 0;
+	for(sl_node* node = skiplist->zero_node; node != NULL  &&  is_written; node = node->next_in_layer[0]){
+		sl_memtable_entry* entry = node->data;
+		if(position % RUN_INDEX_INTERVAL == 0)
+			index_keys[position / RUN_INDEX_INTERVAL] = node->key;
+		buffer[buffered_count].key = node->key;
+		buffer[buffered_count].is_tombstone = entry->is_tombstone;
+		buffer[buffered_count].value = entry->value;
+		buffered_count++;
+		position++;
+		if(buffered_count == RUN_BUFFER_ENTRIES){
+			is_written = write_run_entries(fd, buffer, buffered_count);
+			buffered_count = 0;
+		}
+	}
+	is_written = is_written  &&  write_run_entries(fd, buffer, buffered_count);
+
+	//Sparse index behind the entries, then the header and everything on the disk:
+	memcpy(header.magic, RUN_MAGIC, sizeof(header.magic));
+	header.entry_count = entry_count;
+	header.index_interval = RUN_INDEX_INTERVAL;
+	header.index_offset = sizeof(header) + (uint64_t)entry_count * sizeof(sl_run_entry);
+	is_written = is_written  &&  write(fd, index_keys, sizeof(unsigned int) * index_count) == (ssize_t)(sizeof(unsigned int) * index_count)  &&
+				 fdatasync(fd) == 0  &&  pwrite(fd, &header, sizeof(header), 0) == sizeof(header)  &&  fdatasync(fd) == 0;
+
+	//link() instead of rename() fails if the name is taken, an existing run is never replaced. The directory
+	//is synced so the name survives a crash:
+	is_written = is_written  &&  link(temporary_path, path) == 0;
+	if(fd >= 0)
+		unlink(temporary_path);
+	is_written = is_written  &&  sync_memtable_directory(memtable->directory);
+
+	free(buffer);
+	if(!is_written){
+		if(fd >= 0)
+			close(fd);
+		free(index_keys);
+		free(run);
+		return NULL;
+	}
+	run->fd = fd;
+	run->sequence = sequence;
+	run->entry_count = entry_count;
+	run->index_keys = index_keys;
+	run->next_run = NULL;
+	return run;
+}
+
+//Returns true if run has an entry of key, one pread() of the interval the sparse index points at. Sets is_failed
+//if that pread() fails, the key may be in the run then
+bool find_in_memtable_run(sl_memtable_run* run, unsigned int key, sl_run_entry* found_entry, bool* is_failed){
+	if(run->entry_count == 0  ||  key < run->index_keys[0])
+		return false;
+
+	//Last interval whose first key is <= key:
+	unsigned int index_count = (run->entry_count + RUN_INDEX_INTERVAL - 1) / RUN_INDEX_INTERVAL;
+	unsigned int low = 0;
+	unsigned int high = index_count - 1;
+	while(low < high){
+		unsigned int middle = (low + high + 1) / 2;
+		if(run->index_keys[middle] <= key)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+
+	sl_run_entry entries[RUN_INDEX_INTERVAL];
+	unsigned int first_position = low * RUN_INDEX_INTERVAL;
+	unsigned int count = run->entry_count - first_position < RUN_INDEX_INTERVAL ? run->entry_count - first_position : RUN_INDEX_INTERVAL;
+	off_t offset = sizeof(sl_run_header) + (off_t)first_position * sizeof(sl_run_entry);
+	if(pread(run->fd, entries, count * sizeof(sl_run_entry), offset) != (ssize_t)(count * sizeof(sl_run_entry))){
+		*is_failed = true;
+		return false;
+	}
+
+	//Binary search in the interval:
+	low = 0;
+	high = count;
+	while(low < high){
+		unsigned int middle = (low + high) / 2;
+		if(entries[middle].key < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if(low == count  ||  entries[low].key != key)
+		return false;
+	*found_entry = entries[low];
+	return true;
+}
+
+void release_memtable_runs(sl_memtable_run* runs){
+	while(runs != NULL){
+		sl_memtable_run* next_run = runs->next_run;
+		close(runs->fd);
+		free(runs->index_keys);
+		free(runs);
+		runs = next_run;
+	}
+}
+
+//Opens a finished run file and reads its sparse index, returns NULL if the file isn't a complete run
+sl_memtable_run* read_memtable_run(const char* path, unsigned int sequence){
+	int fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return NULL;
+
+	//The header is written last, it's only valid if the whole file was written:
+	sl_run_header header;
+	struct stat status;
+	bool is_valid = fstat(fd, &status) == 0  &&  pread(fd, &header, sizeof(header), 0) == sizeof(header)  &&
+					memcmp(header.magic, RUN_MAGIC, sizeof(header.magic)) == 0  &&  header.index_interval == RUN_INDEX_INTERVAL  &&
+					header.index_offset == sizeof(header) + (uint64_t)header.entry_count * sizeof(sl_run_entry);
+	unsigned int index_count = is_valid ? (header.entry_count + RUN_INDEX_INTERVAL - 1) / RUN_INDEX_INTERVAL : 0;
+	is_valid = is_valid  &&  (uint64_t)status.st_size >= header.index_offset + sizeof(unsigned int) * index_count;
+
+	sl_memtable_run* run = is_valid ? malloc(sizeof(sl_memtable_run)) : NULL;
+	unsigned int* index_keys = is_valid ? malloc(sizeof(unsigned int) * (index_count + 1)) : NULL;
+	if(run == NULL  ||  index_keys == NULL  ||  pread(fd, index_keys, sizeof(unsigned int) * index_count, header.index_offset)
+			!= (ssize_t)(sizeof(unsigned int) * index_count)){
+		close(fd);
+		free(index_keys);
+		free(run);
+		return NULL;
+	}
+	run->fd = fd;
+	run->sequence = sequence;
+	run->entry_count = header.entry_count;
+	run->index_keys = index_keys;
+	run->next_run = NULL;
+	return run;
+}
+
+//Loads the runs of earlier memtables in directory, newest first, and continues after the greatest sequence.
+//A run only gets its name after it was written completely, so every run file has to be read: a missing run
+//would bring back the keys that it deletes or overwrites. Returns false if directory or a run can't be read
+bool load_memtable_runs(sl_memtable* memtable){
+	DIR* directory = opendir(memtable->directory);
+	if(directory == NULL)
+		return false;
+
+	size_t path_size = strlen(memtable->directory) + 32;
+	char path[path_size];
+	struct dirent* file;
+	while((file = readdir(directory)) != NULL){
+		unsigned int sequence;
+		int length = 0;
+		//Only names run-<digits>.sl and run-<digits>.sl.tmp, %n isn't set if .sl is missing:
+		if(strncmp(file->d_name, "run-", 4) != 0  ||  file->d_name[4] < '0'  ||  file->d_name[4] > '9'  ||
+				sscanf(file->d_name, "run-%u.sl%n", &sequence, &length) != 1  ||  length == 0)
+			continue;
+		snprintf(path, path_size, "%s/%s", memtable->directory, file->d_name);
+		//Left over of a crashed flush, it never was a run:
+		if(strcmp(file->d_name + length, ".tmp") == 0){
+			unlink(path);
+			continue;
+		}
+		if(file->d_name[length] != '\0')
+			continue;
+		if(sequence >= memtable->run_count)
+			memtable->run_count = sequence + 1;
+
+		sl_memtable_run* run = read_memtable_run(path, sequence);
+		if(run == NULL){
+			closedir(directory);
+			return false;
+		}
+		//Keep the runs sorted, newest first:
+		sl_memtable_run** link = &memtable->runs;
+		while(*link != NULL  &&  (*link)->sequence > sequence)
+			link = &(*link)->next_run;
+		run->next_run = *link;
+		*link = run;
+	}
+	closedir(directory);
+	return true;
+}
+
+void* run_memtable_flusher(void* argument){
+	sl_memtable* memtable = argument;
+
+	while(true){
+		//Wait for a frozen skip list, frozen skip lists are written before the thread stops:
+		pthread_mutex_lock(&memtable->flush_mutex);
+		while(memtable->pending_count == 0  &&  !memtable->is_stopping)
+			pthread_cond_wait(&memtable->flush_condition, &memtable->flush_mutex);
+		bool is_done = memtable->pending_count == 0  ||  memtable->is_failed;
+		unsigned int sequence = memtable->run_count;
+		pthread_mutex_unlock(&memtable->flush_mutex);
+		if(is_done)
+			break;
+
+		//The oldest frozen skip list is the last one, only this thread removes frozen skip lists:
+		pthread_rwlock_rdlock(&memtable->lock);
+		sl_frozen_list* oldest = memtable->frozen;
+		while(oldest->next_frozen != NULL)
+			oldest = oldest->next_frozen;
+		pthread_rwlock_unlock(&memtable->lock);
+
+		//Written without lock, nobody changes a frozen skip list:
+		sl_memtable_run* run = write_memtable_run(memtable, oldest->skiplist, sequence);
+
+		//Readers find the entries in the run from now on:
+		if(run != NULL){
+			pthread_rwlock_wrlock(&memtable->lock);
+			sl_frozen_list** link = &memtable->frozen;
+			while(*link != oldest)
+				link = &(*link)->next_frozen;
+			*link = NULL;
+			run->next_run = memtable->runs;
+			memtable->runs = run;
+			pthread_rwlock_unlock(&memtable->lock);
+			remove_memtable_list(oldest->skiplist);
+			free(oldest);
+		}
+
+		//A failed run stops all flushes, newer runs must not be read in front of an older frozen skip list:
+		pthread_mutex_lock(&memtable->flush_mutex);
+		if(run != NULL){
+			memtable->pending_count--;
+			memtable->run_count++;
+		}
+		else{
+			memtable->is_failed = true;
+		}
+		pthread_cond_broadcast(&memtable->flushed_condition);
+		pthread_mutex_unlock(&memtable->flush_mutex);
+	}
+	return NULL;
+}
+
+bool write_memtable_entry(sl_memtable* memtable, unsigned int key, uint64_t value, bool is_tombstone){
+	pthread_rwlock_wrlock(&memtable->lock);
+
+	//A later write of the same key changes the entry in place:
+	bool is_inserted;
+	sl_node* node = sl_get_or_insert(memtable->active, key, NULL, &is_inserted);
+	if(node != NULL  &&  is_inserted){
+		node->data = malloc(sizeof(sl_memtable_entry));
+		if(node->data == NULL){
+			sl_remove_node(memtable->active, key);
+			node = NULL;
+		}
+	}
+	if(node != NULL){
+		sl_memtable_entry* entry = node->data;
+		entry->value = value;
+		entry->is_tombstone = is_tombstone;
+
+		//A full active skip list is frozen, the write is kept even if that fails and the next write tries again:
+		if(get_memtable_list_bytes(memtable->active) >= memtable->flush_threshold)
+			freeze_active_list(memtable);
+	}
+
+	pthread_rwlock_unlock(&memtable->lock);
+	return node != NULL;
+}
+
+/*****************************************************************/
+/*************************** Public ******************************/
+/*****************************************************************/
+
+sl_memtable* sl_create_memtable(const char* directory, unsigned int amount_of_layers, size_t flush_threshold){
+	if(amount_of_layers == 0)
+		return NULL;
+	sl_memtable* memtable = malloc(sizeof(sl_memtable));
+	if(memtable == NULL)
+		return NULL;
+	memtable->directory = malloc(strlen(directory) + 1);
+	memtable->active = sl_create_skip_list(amount_of_layers);
+	if(memtable->directory == NULL  ||  memtable->active == NULL){
+		free(memtable->directory);
+		if(memtable->active != NULL)
+			sl_remove_skip_list(memtable->active);
+		free(memtable);
+		return NULL;
+	}
+	strcpy(memtable->directory, directory);
+	memtable->layer_count = amount_of_layers;
+	memtable->flush_threshold = flush_threshold;
+	memtable->frozen = NULL;
+	memtable->runs = NULL;
+	memtable->run_count = 0;
+	memtable->pending_count = 0;
+	memtable->is_stopping = false;
+	memtable->is_failed = false;
+	pthread_rwlock_init(&memtable->lock, NULL);
+	pthread_mutex_init(&memtable->flush_mutex, NULL);
+	pthread_cond_init(&memtable->flush_condition, NULL);
+	pthread_cond_init(&memtable->flushed_condition, NULL);
+
+	//Runs of earlier memtables are read like own runs, new runs continue after them:
+	if(!load_memtable_runs(memtable)  ||  pthread_create(&memtable->flush_thread, NULL, run_memtable_flusher, memtable) != 0){
+		release_memtable_runs(memtable->runs);
+		pthread_cond_destroy(&memtable->flushed_condition);
+		pthread_cond_destroy(&memtable->flush_condition);
+		pthread_mutex_destroy(&memtable->flush_mutex);
+		pthread_rwlock_destroy(&memtable->lock);
+		sl_remove_skip_list(memtable->active);
+		free(memtable->directory);
+		free(memtable);
+		return NULL;
+	}
+	return memtable;
+}
+
+void sl_remove_memtable(sl_memtable* memtable){
+	pthread_mutex_lock(&memtable->flush_mutex);
+	memtable->is_stopping = true;
+	pthread_cond_signal(&memtable->flush_condition);
+	pthread_mutex_unlock(&memtable->flush_mutex);
+	pthread_join(memtable->flush_thread, NULL);
+
+	//Frozen skip lists are only left if a flush failed:
+	while(memtable->frozen != NULL){
+		sl_frozen_list* next_frozen = memtable->frozen->next_frozen;
+		remove_memtable_list(memtable->frozen->skiplist);
+		free(memtable->frozen);
+		memtable->frozen = next_frozen;
+	}
+	release_memtable_runs(memtable->runs);
+	remove_memtable_list(memtable->active);
+
+	pthread_cond_destroy(&memtable->flushed_condition);
+	pthread_cond_destroy(&memtable->flush_condition);
+	pthread_mutex_destroy(&memtable->flush_mutex);
+	pthread_rwlock_destroy(&memtable->lock);
+	free(memtable->directory);
+	free(memtable);
+}
+
+bool sl_memtable_put(sl_memtable* memtable, unsigned int key, uint64_t value){
+	return write_memtable_entry(memtable, key, value, false);
+}
+
+bool sl_memtable_delete(sl_memtable* memtable, unsigned int key){
+	return write_memtable_entry(memtable, key, 0, true);
+}
+
+bool sl_memtable_get(sl_memtable* memtable, unsigned int key, uint64_t* value, bool* is_failed){
+	sl_memtable_entry found_entry;
+	bool is_found = false;
+	bool is_read_failed = false;
+
+	//The skip lists are searched under the read lock, the newest entry of key decides:
+	pthread_rwlock_rdlock(&memtable->lock);
+	sl_node* node = sl_get_node(memtable->active, key);
+	for(sl_frozen_list* frozen = memtable->frozen; node == NULL  &&  frozen != NULL; frozen = frozen->next_frozen)
+		node = sl_get_node(frozen->skiplist, key);
+	if(node != NULL){
+		found_entry = *(sl_memtable_entry*)node->data;
+		is_found = true;
+	}
+	sl_memtable_run* runs = memtable->runs;
+	pthread_rwlock_unlock(&memtable->lock);
+
+	//Runs are read without lock, they are never changed or removed while the memtable exists. A run that
+	//can't be read stops the lookup, an older run may hold a value that the unread one replaced:
+	sl_run_entry run_entry;
+	for(sl_memtable_run* run = runs; !is_found  &&  !is_read_failed  &&  run != NULL; run = run->next_run){
+		if(find_in_memtable_run(run, key, &run_entry, &is_read_failed)){
+			found_entry.value = run_entry.value;
+			found_entry.is_tombstone = run_entry.is_tombstone;
+			is_found = true;
+		}
+	}
+
+	if(is_failed != NULL)
+		*is_failed = is_read_failed;
+	if(!is_found  ||  found_entry.is_tombstone)
+		return false;
+	if(value != NULL)
+		*value = found_entry.value;
+	return true;
+}
+
+bool sl_memtable_flush(sl_memtable* memtable){
+	//An empty active skip list doesn't need a run:
+	pthread_rwlock_wrlock(&memtable->lock);
+	bool is_frozen = memtable->active->zero_node == NULL  ||  freeze_active_list(memtable);
+	pthread_rwlock_unlock(&memtable->lock);
+
+	pthread_mutex_lock(&memtable->flush_mutex);
+	while(memtable->pending_count > 0  &&  !memtable->is_failed)
+		pthread_cond_wait(&memtable->flushed_condition, &memtable->flush_mutex);
+	bool is_flushed = is_frozen  &&  !memtable->is_failed;
+	pthread_mutex_unlock(&memtable->flush_mutex);
+	return is_flushed;
+}
+
+unsigned int sl_memtable_get_run_count(sl_memtable* memtable){
+	pthread_mutex_lock(&memtable->flush_mutex);
+	unsigned int run_count = memtable->run_count;
+	pthread_mutex_unlock(&memtable->flush_mutex);
+	return run_count;
+}
@@ -0,0 +1,470 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "skiplist_mvcc.h"
+#include "skiplist_epoch.h"
+#include "skiplist_random.h"
+
+//Garbage is collected as soon as there are more than MVCC_MINIMUM_GARBAGE old versions and half the node count
+#define MVCC_MINIMUM_GARBAGE 1024
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//one version of the data of a node, removals add a version with is_removed
+typedef struct _sl_mvcc_version{
+	//first member, old versions are freed through it
+	sl_epoch_entry entry;
+	uint64_t version;
+	bool is_removed;
+	void* data;
+	_Atomic(struct _sl_mvcc_version*) older_version;
+}sl_mvcc_version;
+
+//node, next_in_layer holds height + 1 pointers
+typedef struct _sl_mvcc_node{
+	//first member, unlinked nodes are freed through it
+	sl_epoch_entry entry;
+	unsigned int key;
+	unsigned int height;
+	_Atomic(sl_mvcc_version*) newest_version;
+	_Atomic(struct _sl_mvcc_node*) next_in_layer[];
+}sl_mvcc_node;
+
+struct _sl_mvcc_snapshot{
+	sl_mvcc_skip_list* skiplist;
+	uint64_t version;
+	struct _sl_mvcc_snapshot* older_snapshot;
+	struct _sl_mvcc_snapshot* newer_snapshot;
+};
+
+struct _sl_mvcc_skip_list{
+	//sentinel in front of all nodes, its key is never compared
+	sl_mvcc_node* head;
+	unsigned int layer_count;
+	//serializes writers, snapshots are registered under it as well
+	pthread_mutex_t write_lock;
+	//last committed version
+	_Atomic uint64_t version;
+	//snapshots sorted by version, the oldest one decides which versions are garbage
+	sl_mvcc_snapshot* oldest_snapshot;
+	sl_mvcc_snapshot* newest_snapshot;
+	//nodes in the current state and all versions that aren't freed yet
+	atomic_uint node_count;
+	unsigned int version_count;
+	unsigned int collect_threshold;
+	uint64_t random_state;
+};
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+unsigned int get_mvcc_height(sl_mvcc_skip_list* skiplist){
+	return sl_random_height(&skiplist->random_state, skiplist->layer_count - 1);
+}
+
+sl_mvcc_version* create_mvcc_version(uint64_t version_number, bool is_removed, void* data, sl_mvcc_version* older_version){
+	sl_mvcc_version* version = malloc(sizeof(sl_mvcc_version));
+	if(version == NULL)
+		return NULL;
+	version->version = version_number;
+	version->is_removed = is_removed;
+	version->data = data;
+	atomic_init(&version->older_version, older_version);
+	return version;
+}
+
+sl_mvcc_node* create_mvcc_node(unsigned int key, sl_mvcc_version* version, unsigned int height){
+	sl_mvcc_node* node = malloc(sizeof(sl_mvcc_node) + (height + 1) * sizeof(_Atomic(sl_mvcc_node*)));
+	if(node == NULL)
+		return NULL;
+	node->key = key;
+	node->height = height;
+	atomic_init(&node->newest_version, version);
+	for(unsigned int i = 0; i <= height; i++)
+		atomic_init(&node->next_in_layer[i], NULL);
+	return node;
+}
+
+void release_mvcc_entry(sl_epoch_entry* entry){
+	free(entry);
+}
+
+//Returns the version of node that was current at version_number, NULL if the node didn't exist then
+sl_mvcc_version* get_visible_version(sl_mvcc_node* node, uint64_t version_number){
+	//Acquire pairs with the release of the writer that put the version in front, so its fields are visible:
+	sl_mvcc_version* version = atomic_load_explicit(&node->newest_version, memory_order_acquire);
+	//Walk to older versions until one isn't newer than version_number:
+	while(version != NULL  &&  version->version > version_number)
+		version = atomic_load_explicit(&version->older_version, memory_order_acquire);
+	return version;
+}
+
+//Returns the oldest version that a snapshot can still see, only called by writers
+uint64_t get_horizon(sl_mvcc_skip_list* skiplist){
+	if(skiplist->oldest_snapshot != NULL)
+		return skiplist->oldest_snapshot->version;
+	//Without snapshots only the current version is visible:
+	return atomic_load_explicit(&skiplist->version, memory_order_relaxed);
+}
+
+//Retires version and all older versions of its chain, returns their amount
+unsigned int retire_versions(sl_mvcc_version* version){
+	unsigned int retired_count = 0;
+	while(version != NULL){
+		//Relaxed, the chain is cut off already and only the writer reads it:
+		sl_mvcc_version* older_version = atomic_load_explicit(&version->older_version, memory_order_relaxed);
+		sl_epoch_retire(&version->entry, release_mvcc_entry);
+		retired_count++;
+		version = older_version;
+	}
+	return retired_count;
+}
+
+//Cuts the versions behind the first version that's visible at horizon, nobody can reach them anymore
+void prune_versions(sl_mvcc_skip_list* skiplist, sl_mvcc_node* node, uint64_t horizon){
+	sl_mvcc_version* version = get_visible_version(node, horizon);
+	if(version == NULL)
+		return;
+	//Cut the chain before retiring it, readers that are still on it finish before the grace period ends:
+	sl_mvcc_version* older_version = atomic_load_explicit(&version->older_version, memory_order_relaxed);
+	if(older_version != NULL){
+		atomic_store_explicit(&version->older_version, NULL, memory_order_release);
+		skiplist->version_count -= retire_versions(older_version);
+	}
+}
+
+//Unlinks node from the top layer downwards and retires it with all versions, update holds its predecessors
+void unlink_mvcc_node(sl_mvcc_skip_list* skiplist, sl_mvcc_node** update, sl_mvcc_node* node){
+	//Release, the successor was published by a writer under the same lock before:
+	for(int i = node->height; i >= 0; i--)
+		atomic_store_explicit(&update[i]->next_in_layer[i], atomic_load_explicit(&node->next_in_layer[i], memory_order_relaxed), memory_order_release);
+	//Readers that are still on node or its versions finish before the grace period ends:
+	skiplist->version_count -= retire_versions(atomic_load_explicit(&node->newest_version, memory_order_relaxed));
+	sl_epoch_retire(&node->entry, release_mvcc_entry);
+}
+
+//Searches the last node in front of key in every layer, only called by writers
+sl_mvcc_node* find_mvcc_predecessors(sl_mvcc_skip_list* skiplist, unsigned int key, sl_mvcc_node** update){
+	sl_mvcc_node* current_node = skiplist->head;
+	for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
+		//Relaxed, writers hold the write lock, so they only read links of earlier writers that released it:
+		sl_mvcc_node* next_node;
+		while((next_node = atomic_load_explicit(&current_node->next_in_layer[current_layer], memory_order_relaxed)) != NULL
+				&&  next_node->key < key)
+			current_node = next_node;
+		//Remember the predecessor in this layer, the search continues one layer below:
+		update[current_layer] = current_node;
+	}
+	return atomic_load_explicit(&current_node->next_in_layer[0], memory_order_relaxed);
+}
+
+//Searches the first node with a key >= key, only called by readers inside a critical section
+sl_mvcc_node* find_mvcc_first_node(sl_mvcc_skip_list* skiplist, unsigned int key){
+	sl_mvcc_node* current_node = skiplist->head;
+	sl_mvcc_node* next_node = NULL;
+	for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
+		//Acquire pairs with the release of the writer that linked next_node, so its key and tower are visible:
+		while((next_node = atomic_load_explicit(&current_node->next_in_layer[current_layer], memory_order_acquire)) != NULL
+				&&  next_node->key < key)
+			current_node = next_node;
+	}
+	return next_node;
+}
+
+//Prunes every node and unlinks nodes that are removed for all snapshots, needs the write lock and a critical section
+unsigned int collect_garbage(sl_mvcc_skip_list* skiplist){
+	sl_mvcc_node* update[skiplist->layer_count];
+	unsigned int old_version_count = skiplist->version_count;
+	uint64_t horizon = get_horizon(skiplist);
+
+	//Walk layer 0 and keep the last remaining node of every layer as predecessor:
+	for(unsigned int i = 0; i < skiplist->layer_count; i++)
+		update[i] = skiplist->head;
+	sl_mvcc_node* node = atomic_load_explicit(&skiplist->head->next_in_layer[0], memory_order_relaxed);
+	while(node != NULL){
+		sl_mvcc_node* next_node = atomic_load_explicit(&node->next_in_layer[0], memory_order_relaxed);
+		sl_mvcc_version* version = get_visible_version(node, horizon);
+		//Removed before the oldest snapshot (or nonexistent then, which can't be the newest state):
+		if(version != NULL  &&  version->is_removed  &&  version == atomic_load_explicit(&node->newest_version, memory_order_relaxed))
+			unlink_mvcc_node(skiplist, update, node);
+		//Otherwise only its old versions are garbage:
+		else{
+			prune_versions(skiplist, node, horizon);
+			for(unsigned int i = 0; i <= node->height; i++)
+				update[i] = node;
+		}
+		node = next_node;
+	}
+
+	//The next collection waits for half the node count of new garbage:
+	unsigned int garbage_count = skiplist->version_count - atomic_load_explicit(&skiplist->node_count, memory_order_relaxed);
+	unsigned int node_count = atomic_load_explicit(&skiplist->node_count, memory_order_relaxed);
+	skiplist->collect_threshold = garbage_count + (node_count / 2 > MVCC_MINIMUM_GARBAGE ? node_count / 2 : MVCC_MINIMUM_GARBAGE);
+	return old_version_count - skiplist->version_count;
+}
+
+void collect_garbage_if_needed(sl_mvcc_skip_list* skiplist){
+	if(skiplist->version_count - atomic_load_explicit(&skiplist->node_count, memory_order_relaxed) > skiplist->collect_threshold)
+		collect_garbage(skiplist);
+}
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+sl_mvcc_skip_list* sl_create_mvcc_skip_list(unsigned int amount_of_layers){
+	if(amount_of_layers == 0)
+		return NULL;
+	sl_mvcc_skip_list* skiplist = malloc(sizeof(sl_mvcc_skip_list));
+	if(skiplist == NULL)
+		return NULL;
+	skiplist->layer_count = amount_of_layers;
+	pthread_mutex_init(&skiplist->write_lock, NULL);
+	atomic_init(&skiplist->version, 0);
+	skiplist->oldest_snapshot = NULL;
+	skiplist->newest_snapshot = NULL;
+	atomic_init(&skiplist->node_count, 0);
+	skiplist->version_count = 0;
+	skiplist->collect_threshold = MVCC_MINIMUM_GARBAGE;
+	//Every skip list gets its own seed, use sl_mvcc_set_seed() for reproducible heights:
+	sl_mvcc_set_seed(skiplist, sl_random_default_seed(skiplist));
+	//The head has all layers and no versions:
+	skiplist->head = create_mvcc_node(0, NULL, amount_of_layers - 1);
+	if(skiplist->head == NULL){
+		pthread_mutex_destroy(&skiplist->write_lock);
+		free(skiplist);
+		return NULL;
+	}
+	return skiplist;
+}
+
+void sl_remove_mvcc_skip_list(sl_mvcc_skip_list* skiplist){
+	//Unlinked nodes and pruned versions wait for their grace period, the rest is freed right away:
+	sl_mvcc_node* node = skiplist->head;
+	while(node != NULL){
+		sl_mvcc_node* next_node = atomic_load_explicit(&node->next_in_layer[0], memory_order_relaxed);
+		//Free all versions of the node:
+		sl_mvcc_version* version = atomic_load_explicit(&node->newest_version, memory_order_relaxed);
+		while(version != NULL){
+			sl_mvcc_version* older_version = atomic_load_explicit(&version->older_version, memory_order_relaxed);
+			free(version);
+			version = older_version;
+		}
+		free(node);
+		node = next_node;
+	}
+	pthread_mutex_destroy(&skiplist->write_lock);
+	free(skiplist);
+}
+
+bool sl_mvcc_insert_node(sl_mvcc_skip_list* skiplist, unsigned int key, void* data){
+	sl_mvcc_node* update[skiplist->layer_count];
+	bool result = true;
+
+	//Writers are serialized, the critical section keeps retired versions alive while the garbage is collected.
+	//Relaxed, the version number is only read and written under the write lock:
+	pthread_mutex_lock(&skiplist->write_lock);
+	sl_epoch_enter();
+	uint64_t version_number = atomic_load_explicit(&skiplist->version, memory_order_relaxed) + 1;
+	sl_mvcc_node* node = find_mvcc_predecessors(skiplist, key, update);
+
+	if(node != NULL  &&  node->key == key){
+		//Put a new version in front of the old ones:
+		sl_mvcc_version* newest_version = atomic_load_explicit(&node->newest_version, memory_order_relaxed);
+		sl_mvcc_version* version = create_mvcc_version(version_number, false, data, newest_version);
+		if(version == NULL){
+			result = false;
+			goto unlock;
+		}
+		//Release publishes the fields of version to readers that acquire newest_version:
+		atomic_store_explicit(&node->newest_version, version, memory_order_release);
+		//A removed node comes back:
+		if(newest_version->is_removed)
+			atomic_fetch_add_explicit(&skiplist->node_count, 1, memory_order_relaxed);
+		skiplist->version_count++;
+		atomic_store_explicit(&skiplist->version, version_number, memory_order_relaxed);
+		//Older versions that no snapshot sees anymore are garbage:
+		prune_versions(skiplist, node, get_horizon(skiplist));
+	}
+	else{
+		//Create a node with its first version:
+		sl_mvcc_version* version = create_mvcc_version(version_number, false, data, NULL);
+		node = version == NULL ? NULL : create_mvcc_node(key, version, get_mvcc_height(skiplist));
+		if(node == NULL){
+			free(version);
+			result = false;
+			goto unlock;
+		}
+		//The whole tower is initialized before the node gets visible, relaxed because nobody can read it yet:
+		for(unsigned int i = 0; i <= node->height; i++)
+			atomic_store_explicit(&node->next_in_layer[i], atomic_load_explicit(&update[i]->next_in_layer[i], memory_order_relaxed), memory_order_relaxed);
+		//Publish from layer 0 upwards, a reader that finds the node in a layer can descend from it. Release makes
+		//key, tower and version visible to readers that acquire the link:
+		for(unsigned int i = 0; i <= node->height; i++)
+			atomic_store_explicit(&update[i]->next_in_layer[i], node, memory_order_release);
+		atomic_fetch_add_explicit(&skiplist->node_count, 1, memory_order_relaxed);
+		skiplist->version_count++;
+		atomic_store_explicit(&skiplist->version, version_number, memory_order_relaxed);
+	}
+	collect_garbage_if_needed(skiplist);
+
+unlock:
+	sl_epoch_exit();
+	pthread_mutex_unlock(&skiplist->write_lock);
+	return result;
+}
+
+bool sl_mvcc_remove_node(sl_mvcc_skip_list* skiplist, unsigned int key){
+	sl_mvcc_node* update[skiplist->layer_count];
+	bool result = false;
+
+	//Serialized like sl_mvcc_insert_node():
+	pthread_mutex_lock(&skiplist->write_lock);
+	sl_epoch_enter();
+	uint64_t version_number = atomic_load_explicit(&skiplist->version, memory_order_relaxed) + 1;
+	sl_mvcc_node* node = find_mvcc_predecessors(skiplist, key, update);
+	//Nothing to remove if the key doesn't exist or is removed already:
+	if(node == NULL  ||  node->key != key)
+		goto unlock;
+	sl_mvcc_version* newest_version = atomic_load_explicit(&node->newest_version, memory_order_relaxed);
+	if(newest_version->is_removed)
+		goto unlock;
+
+	//Snapshots still need the older versions, the removal is a version as well:
+	sl_mvcc_version* version = create_mvcc_version(version_number, true, NULL, newest_version);
+	if(version == NULL)
+		goto unlock;
+	//Release like the insertion of a version:
+	atomic_store_explicit(&node->newest_version, version, memory_order_release);
+	atomic_fetch_sub_explicit(&skiplist->node_count, 1, memory_order_relaxed);
+	skiplist->version_count++;
+	atomic_store_explicit(&skiplist->version, version_number, memory_order_relaxed);
+	result = true;
+
+	//Without older snapshots the node can leave the skip list right away:
+	uint64_t horizon = get_horizon(skiplist);
+	if(version_number <= horizon)
+		unlink_mvcc_node(skiplist, update, node);
+	else
+		prune_versions(skiplist, node, horizon);
+	collect_garbage_if_needed(skiplist);
+
+unlock:
+	sl_epoch_exit();
+	pthread_mutex_unlock(&skiplist->write_lock);
+	return result;
+}
+
+bool sl_mvcc_get_data(sl_mvcc_skip_list* skiplist, unsigned int key, void** data){
+	//The node and its versions can't be freed before the critical section ends:
+	sl_epoch_enter();
+	sl_mvcc_node* node = find_mvcc_first_node(skiplist, key);
+	//Acquire pairs with the release of the writer that put the newest version in front:
+	sl_mvcc_version* version = node != NULL  &&  node->key == key ? atomic_load_explicit(&node->newest_version, memory_order_acquire) : NULL;
+	bool found = version != NULL  &&  !version->is_removed;
+	if(found  &&  data != NULL)
+		*data = version->data;
+	sl_epoch_exit();
+	return found;
+}
+
+sl_mvcc_snapshot* sl_snapshot(sl_mvcc_skip_list* skiplist){
+	sl_mvcc_snapshot* snapshot = malloc(sizeof(sl_mvcc_snapshot));
+	if(snapshot == NULL)
+		return NULL;
+	snapshot->skiplist = skiplist;
+	snapshot->newer_snapshot = NULL;
+
+	//Registered under the write lock, so no writer prunes a version this snapshot needs:
+	pthread_mutex_lock(&skiplist->write_lock);
+	snapshot->version = atomic_load_explicit(&skiplist->version, memory_order_relaxed);
+	snapshot->older_snapshot = skiplist->newest_snapshot;
+	if(skiplist->newest_snapshot != NULL)
+		skiplist->newest_snapshot->newer_snapshot = snapshot;
+	else
+		skiplist->oldest_snapshot = snapshot;
+	skiplist->newest_snapshot = snapshot;
+	pthread_mutex_unlock(&skiplist->write_lock);
+	return snapshot;
+}
+
+void sl_release_snapshot(sl_mvcc_snapshot* snapshot){
+	sl_mvcc_skip_list* skiplist = snapshot->skiplist;
+
+	//Unregister the snapshot, the versions only it needed are garbage now:
+	pthread_mutex_lock(&skiplist->write_lock);
+	if(snapshot->older_snapshot != NULL)
+		snapshot->older_snapshot->newer_snapshot = snapshot->newer_snapshot;
+	else
+		skiplist->oldest_snapshot = snapshot->newer_snapshot;
+	if(snapshot->newer_snapshot != NULL)
+		snapshot->newer_snapshot->older_snapshot = snapshot->older_snapshot;
+	else
+		skiplist->newest_snapshot = snapshot->older_snapshot;
+	sl_epoch_enter();
+	collect_garbage_if_needed(skiplist);
+	sl_epoch_exit();
+	pthread_mutex_unlock(&skiplist->write_lock);
+	free(snapshot);
+}
+
+bool sl_snapshot_get_data(sl_mvcc_snapshot* snapshot, unsigned int key, void** data){
+	//Like sl_mvcc_get_data(), but with the version that was current when the snapshot was taken:
+	sl_epoch_enter();
+	sl_mvcc_node* node = find_mvcc_first_node(snapshot->skiplist, key);
+	sl_mvcc_version* version = node != NULL  &&  node->key == key ? get_visible_version(node, snapshot->version) : NULL;
+	bool found = version != NULL  &&  !version->is_removed;
+	if(found  &&  data != NULL)
+		*data = version->data;
+	sl_epoch_exit();
+	return found;
+}
+
+unsigned int sl_snapshot_scan_range(sl_mvcc_snapshot* snapshot, unsigned int minimum_key, unsigned int maximum_key, sl_mvcc_visit_function visit, void* context){
+	unsigned int visited_count = 0;
+
+	//Walk layer 0 from the first key in range, acquire like find_mvcc_first_node():
+	sl_epoch_enter();
+	for(sl_mvcc_node* current_node = find_mvcc_first_node(snapshot->skiplist, minimum_key);
+		current_node != NULL  &&  current_node->key <= maximum_key;
+		current_node = atomic_load_explicit(&current_node->next_in_layer[0], memory_order_acquire)){
+
+		//Skip nodes that didn't exist or were removed at the time of the snapshot:
+		sl_mvcc_version* version = get_visible_version(current_node, snapshot->version);
+		if(version == NULL  ||  version->is_removed)
+			continue;
+
+		visited_count++;
+		//Stop when visit() asks for it:
+		if(!visit(current_node->key, version->data, context))
+			break;
+	}
+	sl_epoch_exit();
+	return visited_count;
+}
+
+unsigned int sl_mvcc_collect_garbage(sl_mvcc_skip_list* skiplist){
+	pthread_mutex_lock(&skiplist->write_lock);
+	sl_epoch_enter();
+	unsigned int freed_count = collect_garbage(skiplist);
+	sl_epoch_exit();
+	pthread_mutex_unlock(&skiplist->write_lock);
+	return freed_count;
+}
+
+unsigned int sl_mvcc_get_node_count(sl_mvcc_skip_list* skiplist){
+	return atomic_load_explicit(&skiplist->node_count, memory_order_relaxed);
+}
+
+void sl_mvcc_set_seed(sl_mvcc_skip_list* skiplist, uint64_t seed){
+	//The state is advanced by writers:
+	pthread_mutex_lock(&skiplist->write_lock);
+	skiplist->random_state = sl_random_state(seed);
+	pthread_mutex_unlock(&skiplist->write_lock);
+}
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <pthread.h>
+#include "skiplist.h"
+#include "skiplist_sharded.h"
+
+//Insertions rebalance as soon as a shard holds more than SHARD_SKEW_PERCENT percent of the average
+//plus SHARD_MINIMUM_NODES nodes. Below 100 * shard_count percent, so it also works for two shards:
+#define SHARD_SKEW_PERCENT 150
+#define SHARD_MINIMUM_NODES 1024
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//one key range [minimum_key, minimum_key of the next shard)
+typedef struct{
+	sl_skip_list* skiplist;
+	pthread_rwlock_t lock;
+	//only changed while all shards are locked, read without lock by the routing
+	atomic_uint minimum_key;
+}sl_shard;
+
+struct _sl_sharded_skip_list{
+	unsigned int layer_count;
+	unsigned int flags;
+	unsigned int shard_count;
+	//approximate amount of nodes, used to notice skewed shards
+	atomic_uint node_count;
+	//routing table, sorted by minimum_key
+	sl_shard shards[];
+};
+
+//context of sl_sharded_scan_range(), remembers whether visit() stopped the scan
+typedef struct{
+	sl_visit_function visit;
+	void* context;
+	bool is_stopped;
+}sl_shard_scan;
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+//Returns the last shard whose minimum_key is <= key
+unsigned int route_key(sl_sharded_skip_list* skiplist, unsigned int key){
+	unsigned int low = 0;
+	unsigned int high = skiplist->shard_count - 1;
+	while(low < high){
+		unsigned int middle = (low + high + 1) / 2;
+		if(atomic_load_explicit(&skiplist->shards[middle].minimum_key, memory_order_relaxed) <= key)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+	return low;
+}
+
+//Returns the highest key of a shard, the shard must be locked
+unsigned int get_shard_maximum_key(sl_sharded_skip_list* skiplist, unsigned int shard){
+	if(shard + 1 == skiplist->shard_count)
+		return UINT_MAX;
+	return atomic_load_explicit(&skiplist->shards[shard + 1].minimum_key, memory_order_relaxed) - 1;
+}
+
+void lock_shard(sl_shard* shard, bool is_writing){
+	if(is_writing)
+		pthread_rwlock_wrlock(&shard->lock);
+	else
+		pthread_rwlock_rdlock(&shard->lock);
+}
+
+//Locks the shard of key and returns its index, retries if the boundaries moved before the lock was taken
+unsigned int lock_shard_of(sl_sharded_skip_list* skiplist, unsigned int key, bool is_writing){
+	while(true){
+		unsigned int shard = route_key(skiplist, key);
+		lock_shard(&skiplist->shards[shard], is_writing);
+		if(atomic_load_explicit(&skiplist->shards[shard].minimum_key, memory_order_relaxed) <= key
+				&&  key <= get_shard_maximum_key(skiplist, shard))
+			return shard;
+		pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+	}
+}
+
+bool visit_shard_node(sl_node* node, void* context){
+	sl_shard_scan* scan = context;
+	if(!scan->visit(node, scan->context)){
+		scan->is_stopped = true;
+		return false;
+	}
+	return true;
+}
+
+//Checks if one shard holds too many nodes, the shards must be locked
+bool is_skewed(sl_sharded_skip_list* skiplist, unsigned int node_count, unsigned int total_count){
+	//node_count > SHARD_SKEW_PERCENT / 100 * total_count / shard_count + SHARD_MINIMUM_NODES without rounding the average down:
+	unsigned long long scaled_count = (unsigned long long)node_count * skiplist->shard_count * 100;
+	return scaled_count > (unsigned long long)SHARD_SKEW_PERCENT * total_count + (unsigned long long)SHARD_MINIMUM_NODES * skiplist->shard_count * 100;
+}
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+sl_sharded_skip_list* sl_create_sharded_skip_list(unsigned int amount_of_layers, unsigned int amount_of_shards, unsigned int flags){
+	//Check parameters:
+	if(amount_of_layers == 0  ||  amount_of_shards == 0)
+		return NULL;
+
+	sl_sharded_skip_list* skiplist = malloc(sizeof(sl_sharded_skip_list) + amount_of_shards * sizeof(sl_shard));
+	if(skiplist == NULL)
+		return NULL;
+	skiplist->layer_count = amount_of_layers;
+	skiplist->flags = flags;
+	skiplist->shard_count = amount_of_shards;
+	atomic_init(&skiplist->node_count, 0);
+
+	//Split the key space evenly:
+	unsigned long long range = ((unsigned long long)UINT_MAX + 1) / amount_of_shards;
+	for(unsigned int i = 0; i < amount_of_shards; i++){
+		sl_shard* shard = &skiplist->shards[i];
+		shard->skiplist = sl_create_custom_skip_list(amount_of_layers, flags, NULL);
+		if(shard->skiplist == NULL){
+			for(unsigned int j = 0; j < i; j++){
+				sl_remove_skip_list(skiplist->shards[j].skiplist);
+				pthread_rwlock_destroy(&skiplist->shards[j].lock);
+			}
+			free(skiplist);
+			return NULL;
+		}
+		pthread_rwlock_init(&shard->lock, NULL);
+		atomic_init(&shard->minimum_key, (unsigned int)(i * range));
+	}
+	return skiplist;
+}
+
+void sl_remove_sharded_skip_list(sl_sharded_skip_list* skiplist){
+	for(unsigned int i = 0; i < skiplist->shard_count; i++){
+		sl_remove_skip_list(skiplist->shards[i].skiplist);
+		pthread_rwlock_destroy(&skiplist->shards[i].lock);
+	}
+	free(skiplist);
+}
+
+bool sl_sharded_insert_node(sl_sharded_skip_list* skiplist, unsigned int key, void* data){
+	unsigned int shard = lock_shard_of(skiplist, key, true);
+	sl_skip_list* shard_skiplist = skiplist->shards[shard].skiplist;
+	unsigned int old_count = shard_skiplist->node_count_in_layer[0];
+	bool result = sl_insert_node(shard_skiplist, key, data);
+	unsigned int new_count = shard_skiplist->node_count_in_layer[0];
+	pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+
+	//Only new nodes can skew the shards, replaced ones don't:
+	if(new_count > old_count){
+		unsigned int total_count = atomic_fetch_add(&skiplist->node_count, 1) + 1;
+		if(is_skewed(skiplist, new_count, total_count))
+			sl_rebalance_shards(skiplist);
+	}
+	return result;
+}
+
+bool sl_sharded_get_data(sl_sharded_skip_list* skiplist, unsigned int key, void** data){
+	unsigned int shard = lock_shard_of(skiplist, key, false);
+	sl_node* node = sl_get_node(skiplist->shards[shard].skiplist, key);
+	if(node != NULL  &&  data != NULL)
+		*data = node->data;
+	pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+	return node != NULL;
+}
+
+bool sl_sharded_remove_node(sl_sharded_skip_list* skiplist, unsigned int key){
+	unsigned int shard = lock_shard_of(skiplist, key, true);
+	bool result = sl_remove_node(skiplist->shards[shard].skiplist, key);
+	pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+	if(result)
+		atomic_fetch_sub(&skiplist->node_count, 1);
+	return result;
+}
+
+unsigned int sl_sharded_scan_range(sl_sharded_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_visit_function visit, void* context){
+	if(minimum_key > maximum_key)
+		return 0;
+
+	sl_shard_scan scan = { .visit = visit, .context = context, .is_stopped = false };
+	unsigned int visited_count = 0;
+
+	//Hand over the locks from shard to shard, so the boundaries can't move in between:
+	unsigned int shard = lock_shard_of(skiplist, minimum_key, false);
+	while(true){
+		unsigned int shard_maximum_key = get_shard_maximum_key(skiplist, shard);
+		unsigned int last_key = shard_maximum_key < maximum_key ? shard_maximum_key : maximum_key;
+		visited_count += sl_scan_range(skiplist->shards[shard].skiplist, minimum_key, last_key, visit_shard_node, &scan);
+
+		if(scan.is_stopped  ||  last_key == maximum_key)
+			break;
+		lock_shard(&skiplist->shards[shard + 1], false);
+		pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+		minimum_key = last_key + 1;
+		shard++;
+	}
+	pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+	return visited_count;
+}
+
+unsigned int sl_sharded_remove_node_range(sl_sharded_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key){
+	if(minimum_key > maximum_key)
+		return 0;
+
+	unsigned int removed_count = 0;
+
+	//Hand over the locks from shard to shard, so the boundaries can't move in between:
+	unsigned int shard = lock_shard_of(skiplist, minimum_key, true);
+	while(true){
+		unsigned int shard_maximum_key = get_shard_maximum_key(skiplist, shard);
+		unsigned int last_key = shard_maximum_key < maximum_key ? shard_maximum_key : maximum_key;
+		removed_count += sl_remove_node_range(skiplist->shards[shard].skiplist, minimum_key, last_key);
+
+		if(last_key == maximum_key)
+			break;
+		lock_shard(&skiplist->shards[shard + 1], true);
+		pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+		minimum_key = last_key + 1;
+		shard++;
+	}
+	pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+	atomic_fetch_sub(&skiplist->node_count, removed_count);
+	return removed_count;
+}
+
+bool sl_rebalance_shards(sl_sharded_skip_list* skiplist){
+	unsigned int shard_count = skiplist->shard_count;
+	sl_skip_list* new_skiplists[shard_count];
+	unsigned int new_minimum_keys[shard_count];
+	unsigned int created_count = 0;
+	unsigned int* keys = NULL;
+	void** data = NULL;
+	bool result = true;
+
+	//Lock all shards in ascending order like the range functions do:
+	for(unsigned int i = 0; i < shard_count; i++)
+		pthread_rwlock_wrlock(&skiplist->shards[i].lock);
+
+	//Another thread might have rebalanced already:
+	unsigned int total_count = 0;
+	unsigned int largest_count = 0;
+	for(unsigned int i = 0; i < shard_count; i++){
+		unsigned int node_count = skiplist->shards[i].skiplist->node_count_in_layer[0];
+		total_count += node_count;
+		largest_count = node_count > largest_count ? node_count : largest_count;
+	}
+	if(!is_skewed(skiplist, largest_count, total_count)  ||  total_count < shard_count)
+		goto release;
+
+	//Collect all nodes in key order:
+	keys = malloc(total_count * sizeof(unsigned int));
+	data = malloc(total_count * sizeof(void*));
+	if(keys == NULL  ||  data == NULL){
+		result = false;
+		goto release;
+	}
+	unsigned int index = 0;
+	for(unsigned int i = 0; i < shard_count; i++){
+		for(sl_node* node = skiplist->shards[i].skiplist->zero_node; node != NULL; node = node->next_in_layer[0]){
+			keys[index] = node->key;
+			data[index] = node->data;
+			index++;
+		}
+	}
+
+	//Build the new shards first, the old ones are kept if memory runs out:
+	for(; created_count < shard_count; created_count++){
+		unsigned int first = (unsigned int)((unsigned long long)total_count * created_count / shard_count);
+		unsigned int last = (unsigned int)((unsigned long long)total_count * (created_count + 1) / shard_count);
+		new_minimum_keys[created_count] = created_count == 0 ? 0 : keys[first];
+		new_skiplists[created_count] = sl_create_custom_skip_list(skiplist->layer_count, skiplist->flags, NULL);
+		if(new_skiplists[created_count] == NULL){
+			result = false;
+			goto release;
+		}
+		if(!sl_bulk_load(new_skiplists[created_count], keys + first, data + first, last - first)){
+			created_count++;
+			result = false;
+			goto release;
+		}
+	}
+
+	//Swap the shards and move the boundaries:
+	for(unsigned int i = 0; i < shard_count; i++){
+		sl_remove_skip_list(skiplist->shards[i].skiplist);
+		skiplist->shards[i].skiplist = new_skiplists[i];
+		atomic_store_explicit(&skiplist->shards[i].minimum_key, new_minimum_keys[i], memory_order_relaxed);
+	}
+	created_count = 0;
+
+release:
+	for(unsigned int i = 0; i < created_count; i++)
+		sl_remove_skip_list(new_skiplists[i]);
+	free(keys);
+	free(data);
+	for(unsigned int i = shard_count; i > 0; i--)
+		pthread_rwlock_unlock(&skiplist->shards[i - 1].lock);
+	return result;
+}
+
+unsigned int sl_sharded_get_node_count(sl_sharded_skip_list* skiplist){
+	unsigned int node_count = 0;
+	for(unsigned int i = 0; i < skiplist->shard_count; i++){
+		pthread_rwlock_rdlock(&skiplist->shards[i].lock);
+		node_count += skiplist->shards[i].skiplist->node_count_in_layer[0];
+		pthread_rwlock_unlock(&skiplist->shards[i].lock);
+	}
+	return node_count;
+}
+
+unsigned int sl_sharded_get_shard_node_count(sl_sharded_skip_list* skiplist, unsigned int shard){
+	if(shard >= skiplist->shard_count)
+		return 0;
+	pthread_rwlock_rdlock(&skiplist->shards[shard].lock);
+	unsigned int node_count = skiplist->shards[shard].skiplist->node_count_in_layer[0];
+	pthread_rwlock_unlock(&skiplist->shards[shard].lock);
+	return node_count;
+}
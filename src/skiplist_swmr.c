@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "skiplist_swmr.h"
+#include "skiplist_epoch.h"
+#include "skiplist_random.h"
+
+/*****************************************************************/
+/**************************** Structs ****************************/
+/*****************************************************************/
+
+//node, next_in_layer holds height + 1 pointers
+typedef struct _sl_swmr_node{
+	//first member, removed nodes are freed through it
+	sl_epoch_entry entry;
+	unsigned int key;
+	unsigned int height;
+	_Atomic(void*) data;
+	_Atomic(struct _sl_swmr_node*) next_in_layer[];
+}sl_swmr_node;
+
+struct _sl_swmr_skip_list{
+	//sentinel in front of all nodes, its key is never compared
+	sl_swmr_node* head;
+	unsigned int layer_count;
+	//only changed by the writer
+	atomic_uint node_count;
+	uint64_t random_state;
+};
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+unsigned int get_swmr_height(sl_swmr_skip_list* skiplist){
+	return sl_random_height(&skiplist->random_state, skiplist->layer_count - 1);
+}
+
+sl_swmr_node* create_swmr_node(unsigned int key, void* data, unsigned int height){
+	sl_swmr_node* node = malloc(sizeof(sl_swmr_node) + (height + 1) * sizeof(_Atomic(sl_swmr_node*)));
+	if(node == NULL)
+		return NULL;
+	node->key = key;
+	node->height = height;
+	atomic_init(&node->data, data);
+	for(unsigned int i = 0; i <= height; i++)
+		atomic_init(&node->next_in_layer[i], NULL);
+	return node;
+}
+
+void release_swmr_node(sl_epoch_entry* entry){
+	free(entry);
+}
+
+//Searches the last node in front of key in every layer, only called by the writer
+sl_swmr_node* find_swmr_predecessors(sl_swmr_skip_list* skiplist, unsigned int key, sl_swmr_node** update){
+	sl_swmr_node* current_node = skiplist->head;
+	for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
+		//Relaxed, the writer reads only links it stored itself:
+		sl_swmr_node* next_node;
+		while((next_node = atomic_load_explicit(&current_node->next_in_layer[current_layer], memory_order_relaxed)) != NULL
+				&&  next_node->key < key)
+			current_node = next_node;
+		//Remember the predecessor in this layer, the search continues one layer below:
+		update[current_layer] = current_node;
+	}
+	return atomic_load_explicit(&current_node->next_in_layer[0], memory_order_relaxed);
+}
+
+//Searches the first node with a key >= key, only called by readers inside a critical section
+sl_swmr_node* find_swmr_first_node(sl_swmr_skip_list* skiplist, unsigned int key){
+	sl_swmr_node* current_node = skiplist->head;
+	sl_swmr_node* next_node = NULL;
+	for(int current_layer = skiplist->layer_count - 1; current_layer >= 0; current_layer--){
+		//Acquire pairs with the release of the writer that linked next_node, so its key and tower are visible:
+		while((next_node = atomic_load_explicit(&current_node->next_in_layer[current_layer], memory_order_acquire)) != NULL
+				&&  next_node->key < key)
+			current_node = next_node;
+	}
+	return next_node;
+}
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+sl_swmr_skip_list* sl_create_swmr_skip_list(unsigned int amount_of_layers){
+	if(amount_of_layers == 0)
+		return NULL;
+	sl_swmr_skip_list* skiplist = malloc(sizeof(sl_swmr_skip_list));
+	if(skiplist == NULL)
+		return NULL;
+	skiplist->layer_count = amount_of_layers;
+	atomic_init(&skiplist->node_count, 0);
+	//Every skip list gets its own seed, use sl_swmr_set_seed() for reproducible heights:
+	sl_swmr_set_seed(skiplist, sl_random_default_seed(skiplist));
+	//The head has all layers:
+	skiplist->head = create_swmr_node(0, NULL, amount_of_layers - 1);
+	if(skiplist->head == NULL){
+		free(skiplist);
+		return NULL;
+	}
+	return skiplist;
+}
+
+void sl_remove_swmr_skip_list(sl_swmr_skip_list* skiplist){
+	//Removed nodes wait for their grace period, the rest is freed right away:
+	sl_swmr_node* node = skiplist->head;
+	while(node != NULL){
+		sl_swmr_node* next_node = atomic_load_explicit(&node->next_in_layer[0], memory_order_relaxed);
+		free(node);
+		node = next_node;
+	}
+	free(skiplist);
+}
+
+bool sl_swmr_insert_node(sl_swmr_skip_list* skiplist, unsigned int key, void* data){
+	sl_swmr_node* update[skiplist->layer_count];
+
+	//Replace the data of an existing node, release pairs with the acquire of readers that load it:
+	sl_swmr_node* next_node = find_swmr_predecessors(skiplist, key, update);
+	if(next_node != NULL  &&  next_node->key == key){
+		atomic_store_explicit(&next_node->data, data, memory_order_release);
+		return true;
+	}
+
+	sl_swmr_node* node = create_swmr_node(key, data, get_swmr_height(skiplist));
+	if(node == NULL)
+		return false;
+	//The whole tower is initialized before the node gets visible, relaxed because nobody can read it yet:
+	for(unsigned int i = 0; i <= node->height; i++)
+		atomic_store_explicit(&node->next_in_layer[i], atomic_load_explicit(&update[i]->next_in_layer[i], memory_order_relaxed), memory_order_relaxed);
+	//Publish from layer 0 upwards, a reader that finds the node in a layer can descend from it. Release makes
+	//key, data and tower visible to readers that acquire the link:
+	for(unsigned int i = 0; i <= node->height; i++)
+		atomic_store_explicit(&update[i]->next_in_layer[i], node, memory_order_release);
+	//Relaxed, the count is only a snapshot for readers:
+	atomic_store_explicit(&skiplist->node_count, atomic_load_explicit(&skiplist->node_count, memory_order_relaxed) + 1, memory_order_relaxed);
+	return true;
+}
+
+bool sl_swmr_remove_node(sl_swmr_skip_list* skiplist, unsigned int key){
+	sl_swmr_node* update[skiplist->layer_count];
+
+	sl_swmr_node* node = find_swmr_predecessors(skiplist, key, update);
+	if(node == NULL  ||  node->key != key)
+		return false;
+	//Unlink from the top layer downwards, the pointers of node stay valid for readers that are on it. Release
+	//like the insertion, the successor was published by this writer before:
+	for(int i = node->height; i >= 0; i--)
+		atomic_store_explicit(&update[i]->next_in_layer[i], atomic_load_explicit(&node->next_in_layer[i], memory_order_relaxed), memory_order_release);
+	//Relaxed, the count is only a snapshot for readers:
+	atomic_store_explicit(&skiplist->node_count, atomic_load_explicit(&skiplist->node_count, memory_order_relaxed) - 1, memory_order_relaxed);
+
+	//Free node after the grace period:
+	sl_epoch_enter();
+	sl_epoch_retire(&node->entry, release_swmr_node);
+	sl_epoch_exit();
+	return true;
+}
+
+bool sl_swmr_get_data(sl_swmr_skip_list* skiplist, unsigned int key, void** data){
+	//The node can't be freed before the critical section ends:
+	sl_epoch_enter();
+	sl_swmr_node* node = find_swmr_first_node(skiplist, key);
+	bool found = node != NULL  &&  node->key == key;
+	//Acquire pairs with the release of the writer that stored data:
+	if(found  &&  data != NULL)
+		*data = atomic_load_explicit(&node->data, memory_order_acquire);
+	sl_epoch_exit();
+	return found;
+}
+
+unsigned int sl_swmr_scan_range(sl_swmr_skip_list* skiplist, unsigned int minimum_key, unsigned int maximum_key, sl_swmr_visit_function visit, void* context){
+	unsigned int visited_count = 0;
+
+	//Walk layer 0 from the first key in range, acquire like find_swmr_first_node():
+	sl_epoch_enter();
+	for(sl_swmr_node* current_node = find_swmr_first_node(skiplist, minimum_key);
+		current_node != NULL  &&  current_node->key <= maximum_key;
+		current_node = atomic_load_explicit(&current_node->next_in_layer[0], memory_order_acquire)){
+
+		visited_count++;
+		//Stop when visit() asks for it:
+		if(!visit(current_node->key, atomic_load_explicit(&current_node->data, memory_order_acquire), context))
+			break;
+	}
+	sl_epoch_exit();
+	return visited_count;
+}
+
+unsigned int sl_swmr_get_node_count(sl_swmr_skip_list* skiplist){
+	return atomic_load_explicit(&skiplist->node_count, memory_order_relaxed);
+}
+
+void sl_swmr_set_seed(sl_swmr_skip_list* skiplist, uint64_t seed){
+	skiplist->random_state = sl_random_state(seed);
+}
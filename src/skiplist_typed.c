@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "skiplist_typed.h"
+
+/*****************************************************************/
+/*************************** Private *****************************/
+/*****************************************************************/
+
+int compare_bytes(sl_bytes a, sl_bytes b){
+	size_t length = a.length < b.length ? a.length : b.length;
+	int comparison = memcmp(a.bytes, b.bytes, length);
+	if(comparison != 0)
+		return comparison;
+	return (a.length > b.length) - (a.length < b.length);
+}
+
+sl_bytes copy_bytes(sl_bytes key, unsigned char* storage){
+	memcpy(storage, key.bytes, key.length);
+	return (sl_bytes){ .bytes = storage, .length = key.length };
+}
+
+#define SL_COMPARE_BYTES(skiplist, a, b) compare_bytes(a, b)
+#define SL_BYTES_SIZE(skiplist, key) ((key).length)
+#define SL_COPY_BYTES(skiplist, key, storage) copy_bytes(key, storage)
+
+#define SL_COMPARE_GENERIC(skiplist, a, b) (skiplist)->compare(a, b)
+#define SL_GENERIC_SIZE(skiplist, key) ((skiplist)->key_size)
+#define SL_COPY_GENERIC(skiplist, key, storage) ((const void*)memcpy(storage, key, (skiplist)->key_size))
+
+/*****************************************************************/
+/**************************** Public *****************************/
+/*****************************************************************/
+
+SL_DEFINE_TYPED_SKIP_LIST(u32, uint32_t, SL_COMPARE_INTEGERS, SL_NO_KEY_SIZE, SL_KEEP_KEY)
+
+SL_DEFINE_TYPED_SKIP_LIST(u64, uint64_t, SL_COMPARE_INTEGERS, SL_NO_KEY_SIZE, SL_KEEP_KEY)
+
+SL_DEFINE_TYPED_SKIP_LIST(bytes, sl_bytes, SL_COMPARE_BYTES, SL_BYTES_SIZE, SL_COPY_BYTES)
+
+//The generic instance has no constructor without comparator, SL_COMPARE_GENERIC would call NULL:
+SL_DEFINE_TYPED_SKIP_LIST_CORE(generic, const void*, SL_COMPARE_GENERIC, SL_GENERIC_SIZE, SL_COPY_GENERIC)
+
+sl_generic_skip_list* sl_create_comparator_skip_list(unsigned int amount_of_layers, size_t key_size, sl_compare_function compare){
+	//Check parameter:
+	if(compare == NULL)
+		return NULL;
+	return create_generic_skip_list(amount_of_layers, compare, key_size);
+}